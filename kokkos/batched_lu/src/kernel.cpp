@@ -0,0 +1,215 @@
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+#include "launch_tuning.hpp"
+
+using namespace Kokkos;
+
+// Batched solver for many small dense systems (chemistry Jacobians and the
+// like, 5-30 unknowns), built like the optimized Thomas solver: one team per
+// system, the system factored in team scratch, and the elimination spread
+// over team threads (rows) and vector lanes (columns).  LU with partial
+// pivoting; A and b are left untouched.
+
+using MemSpace = DefaultExecutionSpace::memory_space;
+using ExecSpace = DefaultExecutionSpace;
+
+// (system, row, column): each system's matrix is one contiguous block
+using MatrixBatch = View<double***, LayoutRight, MemSpace>;
+using VectorBatch = View<double**, LayoutRight, MemSpace>;
+
+// Team scratch for one m x m system: the working copy of A and the right
+// hand side.
+inline size_t lu_scratch_bytes(int m) { return size_t(m * m + m) * sizeof(double); }
+
+// Solves A(s) x(s) = b(s) for every system s.  info(s) is 0 on success or,
+// as in LAPACK getrf, k+1 when the k-th pivot is zero or NaN; x(s) is then NaN.
+void lu_solve_batched(const ExecSpace& exec, int m, View<const double***, LayoutRight, MemSpace> A,
+                      View<const double**, LayoutRight, MemSpace> b, VectorBatch x, View<int*, MemSpace> info,
+                      const tuning::LaunchParams& launch) {
+  const int nbatch = int(A.extent(0));
+  auto policy = tuning::make_team_policy(exec, nbatch, launch);
+
+  // Scratch: the m x m working copy of A (row-major) and the right hand side
+  const size_t scratch_bytes = lu_scratch_bytes(m);
+  policy.set_scratch_size(0, PerTeam(scratch_bytes));
+
+  parallel_for("batched_lu_solve", policy, KOKKOS_LAMBDA(const TeamPolicy<ExecSpace>::member_type& team) {
+    const int s = team.league_rank();
+    double* lu = (double*)team.team_scratch(0).get_shmem(scratch_bytes);
+    double* rhs = lu + m * m;
+
+    parallel_for(TeamVectorRange(team, m * m), [&](const int e) { lu[e] = A(s, e / m, e % m); });
+    parallel_for(TeamVectorRange(team, m), [&](const int r) { rhs[r] = b(s, r); });
+    team.team_barrier();
+
+    // Elimination; the right hand side is carried along, so no separate
+    // forward substitution or pivot vector is needed
+    int singular = 0;
+    for (int k = 0; k < m; k++) {
+      // Partial pivoting: largest |lu(r,k)| for r >= k, known to every thread
+      MaxLoc<double, int>::value_type pivot;
+      parallel_reduce(TeamThreadRange(team, k, m), [&](const int r, MaxLoc<double, int>::value_type& best) {
+        const double v = std::abs(lu[r * m + k]);
+        if (v > best.val) {
+          best.val = v;
+          best.loc = r;
+        }
+      }, MaxLoc<double, int>(pivot));
+      // Also catches a column of NaNs, where no candidate beats the MaxLoc
+      // identity and pivot.loc is not a row
+      if (!(pivot.val > 0.0)) {
+        singular = k + 1;
+        break;
+      }
+      const int p = pivot.loc;
+      if (p != k) {
+        parallel_for(TeamVectorRange(team, m), [&](const int c) {
+          const double t = lu[k * m + c];
+          lu[k * m + c] = lu[p * m + c];
+          lu[p * m + c] = t;
+        });
+        single(PerTeam(team), [&]() {
+          const double t = rhs[k];
+          rhs[k] = rhs[p];
+          rhs[p] = t;
+        });
+      }
+      team.team_barrier();
+
+      const double inv_pivot = 1.0 / lu[k * m + k];
+      parallel_for(TeamThreadRange(team, k + 1, m), [&](const int r) {
+        const double l = lu[r * m + k] * inv_pivot;
+        parallel_for(ThreadVectorRange(team, k + 1, m), [&](const int c) { lu[r * m + c] -= l * lu[k * m + c]; });
+        single(PerThread(team), [&]() {
+          lu[r * m + k] = l;
+          rhs[r] -= l * rhs[k];
+        });
+      });
+      team.team_barrier();
+    }
+
+    if (singular != 0) {
+      parallel_for(TeamVectorRange(team, m), [&](const int r) { x(s, r) = NAN; });
+      single(PerTeam(team), [&]() { info(s) = singular; });
+      return;
+    }
+
+    // Back substitution by columns: x(k) is final once rows below are done,
+    // then its contribution is removed from every row above in parallel
+    for (int k = m - 1; k >= 0; k--) {
+      const double xk = rhs[k] / lu[k * m + k];
+      single(PerTeam(team), [&]() { x(s, k) = xk; });
+      parallel_for(TeamVectorRange(team, k), [&](const int r) { rhs[r] -= lu[r * m + k] * xk; });
+      team.team_barrier();
+    }
+    single(PerTeam(team), [&]() { info(s) = 0; });
+  });
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <nbatch> <reps> [--m <unknowns>]" << std::endl;
+    std::cerr << "  options: --tune  --tuning-cache <path>" << std::endl;
+    return 1;
+  }
+
+  int nbatch = std::atoi(argv[1]);
+  int reps = std::atoi(argv[2]);
+  int m = 16;  // unknowns per system
+  for (int i = 3; i + 1 < argc; i++) {
+    if (std::string(argv[i]) == "--m") m = std::atoi(argv[i+1]);
+  }
+  if (nbatch < 1 || reps < 1 || m < 1) {
+    std::cerr << "Error: nbatch, reps and m must be positive" << std::endl;
+    return 1;
+  }
+
+  initialize(argc, argv);
+  if (lu_scratch_bytes(m) > size_t(TeamPolicy<ExecSpace>::scratch_size_max(0))) {
+    std::cerr << "Error: m=" << m << " needs " << lu_scratch_bytes(m) << " bytes of team scratch, "
+              << ExecSpace::name() << " provides " << TeamPolicy<ExecSpace>::scratch_size_max(0) << std::endl;
+    finalize();
+    return 1;
+  }
+  {
+    constexpr double pi = 3.141592653589793;
+    MatrixBatch A("A", nbatch, m, m);
+    VectorBatch b("b", nbatch, m);
+    VectorBatch x("x", nbatch, m);
+    View<int*, MemSpace> info("info", nbatch);
+
+    // Test systems: a smooth dense part plus a dominant entry just off the
+    // diagonal, so every system needs row interchanges
+    parallel_for("init_systems", MDRangePolicy<Rank<3>>({0,0,0}, {nbatch,m,m}), KOKKOS_LAMBDA(int s, int r, int c) {
+      A(s,r,c) = std::cos(pi * double((r+1) * (c+2)) / double(m+1) + 0.01 * double(s)) + ((c == (r+1) % m) ? 2.0 * m : 0.0);
+      if (c == 0) b(s,r) = std::sin(pi * double(r+1) / double(m) + 0.001 * double(s));
+    });
+    fence();
+
+    View<const double***, LayoutRight, MemSpace> A_const = A;
+    View<const double**, LayoutRight, MemSpace> b_const = b;
+    ExecSpace exec;
+
+    // Launch parameters: searched with --tune, otherwise loaded from the cache
+    tuning::LaunchTuner tuner = tuning::LaunchTuner::from_args(argc, argv);
+    const tuning::LaunchParams launch =
+        tuner.select("batched_lu_m" + std::to_string(m), long(nbatch) * m * m, tuning::LaunchParams{},
+                     tuning::team_candidates(std::min(ExecSpace().concurrency(), m)),
+                     [&](const tuning::LaunchParams& p) { lu_solve_batched(exec, m, A_const, b_const, x, info, p); });
+
+    // Warmup iterations
+    for (int warmup = 0; warmup < 3; warmup++) {
+      lu_solve_batched(exec, m, A_const, b_const, x, info, launch);
+    }
+    exec.fence("batched_lu_warmup");
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int rep = 0; rep < reps; rep++) {
+      lu_solve_batched(exec, m, A_const, b_const, x, info, launch);
+    }
+    exec.fence("batched_lu_benchmark");
+    auto end = std::chrono::high_resolution_clock::now();
+    double time_per_iter = std::chrono::duration<double>(end - start).count() / reps;
+
+    // Validation: residual max |A x - b| and singular systems
+    double max_residual = 0.0;
+    parallel_reduce("residual", nbatch, KOKKOS_LAMBDA(int s, double& worst) {
+      for (int r = 0; r < m; r++) {
+        double sum = -b(s,r);
+        for (int c = 0; c < m; c++) sum += A(s,r,c) * x(s,c);
+        worst = std::max(worst, std::abs(sum));
+      }
+    }, Max<double>(max_residual));
+    int singular = 0;
+    parallel_reduce("count_singular", nbatch, KOKKOS_LAMBDA(int s, int& count) {
+      count += (info(s) != 0) ? 1 : 0;
+    }, singular);
+
+    // 2/3 m^3 for the factorization, 2 m^2 for the solves
+    const double flops = double(nbatch) * (2.0 / 3.0 * m * m * m + 2.0 * m * m);
+    std::cerr << "Time per iteration: " << std::fixed << std::setprecision(4) << time_per_iter << " seconds"
+              << std::endl;
+    std::cerr << "Throughput: " << std::fixed << std::setprecision(2) << flops / time_per_iter * 1e-9 << " GFLOP/s ("
+              << nbatch << " systems of " << m << " unknowns)" << std::endl;
+    std::cerr << "Max residual: " << std::scientific << std::setprecision(3) << max_residual << ", singular systems: "
+              << singular << std::defaultfloat << std::endl;
+
+    auto h_x = create_mirror_view_and_copy(HostSpace{}, x);
+    for (int s = 0; s < nbatch; s++) {
+      for (int r = 0; r < m; r++) {
+        std::cout << std::fixed << std::setprecision(10) << h_x(s,r);
+        if (r < m-1) std::cout << ",";
+      }
+      std::cout << std::endl;
+    }
+  }
+  finalize();
+
+  return 0;
+}
@@ -4,6 +4,8 @@
 #include <iostream>
 #include <iomanip>
 
+#include "numa_topology.hpp"
+
 int main(int argc, char* argv[]) {
     if (argc < 3) {
         std::cerr << "Usage: " << argv[0] << " --n <n> --reps <reps>" << std::endl;
@@ -26,13 +28,20 @@ int main(int argc, char* argv[]) {
         using ViewType = Kokkos::View<double**, Kokkos::LayoutLeft>;
         using VectorType = Kokkos::View<double*>;
         
-        // Allocate arrays
-        ViewType A("A", n, n);
-        VectorType x("x", n);
-        VectorType b("b", n);
-        VectorType r("r", n);
-        VectorType p("p", n);
-        VectorType Ap("Ap", n);
+        numa::report_topology(std::cerr);
+        
+        // Allocate arrays without Kokkos' zero fill, which splits A along its
+        // span (i.e. by column j) and would place each thread's rows on
+        // whichever socket filled those columns.  init_matrix below is the
+        // first touch instead, with the same row partitioning as the matvec
+        // and vector kernels.
+        auto uninit = [](const char* label) { return Kokkos::view_alloc(Kokkos::WithoutInitializing, label); };
+        ViewType A(uninit("A"), n, n);
+        VectorType x(uninit("x"), n);
+        VectorType b(uninit("b"), n);
+        VectorType r(uninit("r"), n);
+        VectorType p(uninit("p"), n);
+        VectorType Ap(uninit("Ap"), n);
         
         // Initialize - simple symmetric positive definite matrix
         Kokkos::parallel_for("init_matrix", Kokkos::RangePolicy<>(0, n),
@@ -48,38 +57,48 @@ int main(int argc, char* argv[]) {
             }
             b(i) = std::sin(3.14159 * static_cast<double>(i + 1) / static_cast<double>(n));
             x(i) = 0.0;
+            r(i) = 0.0;
+            p(i) = 0.0;
+            Ap(i) = 0.0;
         });
         
         Kokkos::fence();
+        
+        // The solve is issued asynchronously on one execution space instance:
+        // dot products reduce into device scalars, alpha/beta are formed on the
+        // device, and convergence sets a device flag that turns the remaining
+        // iterations into no-ops instead of breaking out on the host.  The host
+        // only waits once, on the instance, after the last rep.
+        using ScalarType = Kokkos::View<double>;
+        Kokkos::DefaultExecutionSpace exec;
+        auto range = [&]() { return Kokkos::RangePolicy<>(exec, 0, n); };
+        auto single = [&]() { return Kokkos::RangePolicy<>(exec, 0, 1); };
+        ScalarType rsold("rsold"), rsnew("rsnew"), pAp("pAp"), alpha("alpha"), beta("beta");
+        Kokkos::View<int> done("done");
+        
         auto start_time = std::chrono::high_resolution_clock::now();
         
         for (int rep = 0; rep < reps; rep++) {
-            // Reset solution
-            Kokkos::parallel_for("reset_x", n, KOKKOS_LAMBDA(const int i) {
+            // Reset solution, r = b, p = r
+            Kokkos::parallel_for("reset_x_r_p", range(), KOKKOS_LAMBDA(const int i) {
                 x(i) = 0.0;
-            });
-            
-            // Simple CG iteration
-            // r = b
-            Kokkos::parallel_for("init_r", n, KOKKOS_LAMBDA(const int i) {
                 r(i) = b(i);
+                p(i) = b(i);
             });
-            
-            // p = r
-            Kokkos::parallel_for("init_p", n, KOKKOS_LAMBDA(const int i) {
-                p(i) = r(i);
+            Kokkos::parallel_for("reset_done", single(), KOKKOS_LAMBDA(const int) {
+                done() = 0;
             });
             
             // rsold = dot_product(r, r)
-            double rsold = 0.0;
-            Kokkos::parallel_reduce("dot_r_r", n, KOKKOS_LAMBDA(const int i, double& sum) {
+            Kokkos::parallel_reduce("dot_r_r", range(), KOKKOS_LAMBDA(const int i, double& sum) {
                 sum += r(i) * r(i);
             }, rsold);
             
             int max_iter = (10 < n) ? 10 : n;  // Limited iterations for demo
             for (int iter = 0; iter < max_iter; iter++) {
                 // Ap = A * p
-                Kokkos::parallel_for("matvec", n, KOKKOS_LAMBDA(const int i) {
+                Kokkos::parallel_for("matvec", range(), KOKKOS_LAMBDA(const int i) {
+                    if (done()) return;
                     double sum = 0.0;
                     for (int j = 0; j < n; j++) {
                         sum += A(i, j) * p(j);
@@ -88,48 +107,50 @@ int main(int argc, char* argv[]) {
                 });
                 
                 // pAp = dot_product(p, Ap)
-                double pAp = 0.0;
-                Kokkos::parallel_reduce("dot_p_Ap", n, KOKKOS_LAMBDA(const int i, double& sum) {
+                Kokkos::parallel_reduce("dot_p_Ap", range(), KOKKOS_LAMBDA(const int i, double& sum) {
                     sum += p(i) * Ap(i);
                 }, pAp);
                 
-                if (pAp <= 1e-14) {
-                    break;
-                }
-                
-                double alpha = rsold / pAp;
-                
-                // x = x + alpha * p
-                Kokkos::parallel_for("update_x", n, KOKKOS_LAMBDA(const int i) {
-                    x(i) = x(i) + alpha * p(i);
+                Kokkos::parallel_for("cg_alpha", single(), KOKKOS_LAMBDA(const int) {
+                    if (done()) return;
+                    if (pAp() <= 1e-14) {
+                        done() = 1;
+                    } else {
+                        alpha() = rsold() / pAp();
+                    }
                 });
                 
-                // r = r - alpha * Ap
-                Kokkos::parallel_for("update_r", n, KOKKOS_LAMBDA(const int i) {
-                    r(i) = r(i) - alpha * Ap(i);
+                // x = x + alpha * p, r = r - alpha * Ap
+                Kokkos::parallel_for("update_x_r", range(), KOKKOS_LAMBDA(const int i) {
+                    if (done()) return;
+                    x(i) = x(i) + alpha() * p(i);
+                    r(i) = r(i) - alpha() * Ap(i);
                 });
                 
                 // rsnew = dot_product(r, r)
-                double rsnew = 0.0;
-                Kokkos::parallel_reduce("dot_r_r_new", n, KOKKOS_LAMBDA(const int i, double& sum) {
+                Kokkos::parallel_reduce("dot_r_r_new", range(), KOKKOS_LAMBDA(const int i, double& sum) {
                     sum += r(i) * r(i);
                 }, rsnew);
                 
-                if (std::sqrt(rsnew) < 1e-10) {
-                    break;
-                }
-                
-                double beta = rsnew / rsold;
+                Kokkos::parallel_for("cg_beta", single(), KOKKOS_LAMBDA(const int) {
+                    if (done()) return;
+                    if (std::sqrt(rsnew()) < 1e-10) {
+                        done() = 1;
+                    } else {
+                        beta() = rsnew() / rsold();
+                        rsold() = rsnew();
+                    }
+                });
                 
                 // p = r + beta * p
-                Kokkos::parallel_for("update_p", n, KOKKOS_LAMBDA(const int i) {
-                    p(i) = r(i) + beta * p(i);
+                Kokkos::parallel_for("update_p", range(), KOKKOS_LAMBDA(const int i) {
+                    if (done()) return;
+                    p(i) = r(i) + beta() * p(i);
                 });
-                
-                rsold = rsnew;
             }
         }
         
+        exec.fence();
         auto end_time = std::chrono::high_resolution_clock::now();
         double elapsed = std::chrono::duration<double>(end_time - start_time).count();
         
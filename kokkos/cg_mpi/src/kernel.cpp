@@ -0,0 +1,254 @@
+#include <Kokkos_Core.hpp>
+#include <mpi.h>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// Distributed version of kokkos/cg: the same 4/-1 tridiagonal system, with
+// vectors partitioned into contiguous row blocks, one per rank.  The matrix is
+// applied as a stencil, so the matvec only needs one ghost entry of p from
+// each neighbouring rank; that exchange is overlapped with the interior rows.
+// Dot products are reduced with MPI_Iallreduce, and the x update (which does
+// not depend on the new residual norm) runs while the r.r reduction is in
+// flight.  Time spent waiting on MPI is reported separately from compute.
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+    int rank = 0, nranks = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    if (argc < 3) {
+        if (rank == 0) {
+            std::cerr << "Usage: " << argv[0] << " --n <n> --reps <reps>" << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    int n = 1024, reps = 2;
+
+    // Parse command line arguments
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::string(argv[i]) == "--n") {
+            n = std::atoi(argv[i+1]);
+        } else if (std::string(argv[i]) == "--reps") {
+            reps = std::atoi(argv[i+1]);
+        }
+    }
+
+    if (n < nranks) {
+        if (rank == 0) {
+            std::cerr << "Error: n (" << n << ") must be at least the number of ranks (" << nranks << ")" << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    Kokkos::initialize(argc, argv);
+    {
+        using VectorType = Kokkos::View<double*>;
+
+        // Row-block partition; the first n % nranks ranks own one extra row
+        const int base = n / nranks;
+        const int extra = n % nranks;
+        const int nl = base + (rank < extra ? 1 : 0);
+        const int row0 = rank * base + std::min(rank, extra);
+        const int left = rank > 0 ? rank - 1 : MPI_PROC_NULL;
+        const int right = rank < nranks - 1 ? rank + 1 : MPI_PROC_NULL;
+
+        // Allocate arrays; p carries one ghost entry on each side, p(1..nl)
+        // are the rows owned by this rank
+        VectorType x("x", nl);
+        VectorType b("b", nl);
+        VectorType r("r", nl);
+        VectorType p("p", nl + 2);
+        VectorType Ap("Ap", nl);
+
+        // Ghost exchange buffers: [0] is the left edge, [1] the right edge.
+        // Received values are copied into p(0) and p(nl+1).  Receives from
+        // MPI_PROC_NULL leave the buffer untouched, so the ghost entries at the
+        // global boundary stay zero.
+        VectorType halo_send("halo_send", 2);
+        auto h_halo_send = Kokkos::create_mirror_view(halo_send);
+        Kokkos::View<double*, Kokkos::HostSpace> h_halo_recv("h_halo_recv", 2);
+
+        // Initialize - same right hand side as the single-process kernel
+        Kokkos::parallel_for("init_vectors", Kokkos::RangePolicy<>(0, nl),
+                            KOKKOS_LAMBDA(const int i) {
+            b(i) = std::sin(3.14159 * static_cast<double>(row0 + i + 1) / static_cast<double>(n));
+            x(i) = 0.0;
+        });
+
+        double comm_time = 0.0;
+        auto timed = [&](auto&& mpi_call) {
+            auto t0 = std::chrono::high_resolution_clock::now();
+            mpi_call();
+            comm_time += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - t0).count();
+        };
+
+        // Global dot product: local reduce, then a non-blocking allreduce that
+        // the caller completes with MPI_Wait
+        auto dot_begin = [&](const char* label, VectorType u, int u_offset, VectorType v, double& local,
+                             double& global, MPI_Request& req) {
+            local = 0.0;
+            Kokkos::parallel_reduce(label, nl, KOKKOS_LAMBDA(const int i, double& sum) {
+                sum += u(i + u_offset) * v(i);
+            }, local);
+            timed([&] { MPI_Iallreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &req); });
+        };
+        auto wait = [&](MPI_Request& req) {
+            timed([&] { MPI_Wait(&req, MPI_STATUS_IGNORE); });
+        };
+
+        // Ap = A * p, with the ghost exchange in flight during the interior rows
+        auto matvec = [&]() {
+            Kokkos::parallel_for("pack_halo", 1, KOKKOS_LAMBDA(const int) {
+                halo_send(0) = p(1);
+                halo_send(1) = p(nl);
+            });
+            Kokkos::deep_copy(h_halo_send, halo_send);
+            MPI_Request reqs[4];
+            timed([&] {
+                MPI_Irecv(&h_halo_recv(0), 1, MPI_DOUBLE, left, 1, MPI_COMM_WORLD, &reqs[0]);
+                MPI_Irecv(&h_halo_recv(1), 1, MPI_DOUBLE, right, 0, MPI_COMM_WORLD, &reqs[1]);
+                MPI_Isend(&h_halo_send(0), 1, MPI_DOUBLE, left, 0, MPI_COMM_WORLD, &reqs[2]);
+                MPI_Isend(&h_halo_send(1), 1, MPI_DOUBLE, right, 1, MPI_COMM_WORLD, &reqs[3]);
+            });
+
+            // Interior rows only touch owned entries of p
+            Kokkos::parallel_for("matvec_interior", Kokkos::RangePolicy<>(1, std::max(1, nl - 1)),
+                                KOKKOS_LAMBDA(const int i) {
+                Ap(i) = 4.0 * p(i + 1) - p(i) - p(i + 2);
+            });
+            Kokkos::fence();
+
+            timed([&] { MPI_Waitall(4, reqs, MPI_STATUSES_IGNORE); });
+            Kokkos::deep_copy(Kokkos::subview(p, 0), h_halo_recv(0));
+            Kokkos::deep_copy(Kokkos::subview(p, nl + 1), h_halo_recv(1));
+
+            // First and last owned rows (the same row when nl == 1)
+            const int nedge = nl > 1 ? 2 : 1;
+            Kokkos::parallel_for("matvec_boundary", nedge, KOKKOS_LAMBDA(const int e) {
+                const int i = (e == 0) ? 0 : nl - 1;
+                Ap(i) = 4.0 * p(i + 1) - p(i) - p(i + 2);
+            });
+        };
+
+        Kokkos::fence();
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto start_time = std::chrono::high_resolution_clock::now();
+
+        for (int rep = 0; rep < reps; rep++) {
+            // Reset solution
+            Kokkos::parallel_for("reset_x", nl, KOKKOS_LAMBDA(const int i) {
+                x(i) = 0.0;
+            });
+
+            // r = b, p = r
+            Kokkos::parallel_for("init_r_p", nl, KOKKOS_LAMBDA(const int i) {
+                r(i) = b(i);
+                p(i + 1) = r(i);
+            });
+
+            // rsold = dot_product(r, r)
+            double rr_local = 0.0, rsold = 0.0;
+            MPI_Request req;
+            dot_begin("dot_r_r", r, 0, r, rr_local, rsold, req);
+            wait(req);
+
+            int max_iter = (10 < n) ? 10 : n;  // Limited iterations for demo
+            for (int iter = 0; iter < max_iter; iter++) {
+                matvec();
+
+                // pAp = dot_product(p, Ap); alpha is needed right away, so
+                // there is nothing to overlap with this reduction
+                double pAp_local = 0.0, pAp = 0.0;
+                dot_begin("dot_p_Ap", p, 1, Ap, pAp_local, pAp, req);
+                wait(req);
+
+                if (pAp <= 1e-14) {
+                    break;
+                }
+
+                double alpha = rsold / pAp;
+
+                // r = r - alpha * Ap
+                Kokkos::parallel_for("update_r", nl, KOKKOS_LAMBDA(const int i) {
+                    r(i) = r(i) - alpha * Ap(i);
+                });
+
+                // rsnew = dot_product(r, r), reduced while x is updated
+                double rsnew = 0.0;
+                dot_begin("dot_r_r_new", r, 0, r, rr_local, rsnew, req);
+
+                // x = x + alpha * p
+                Kokkos::parallel_for("update_x", nl, KOKKOS_LAMBDA(const int i) {
+                    x(i) = x(i) + alpha * p(i + 1);
+                });
+                Kokkos::fence();
+                wait(req);
+
+                if (std::sqrt(rsnew) < 1e-10) {
+                    break;
+                }
+
+                double beta = rsnew / rsold;
+
+                // p = r + beta * p
+                Kokkos::parallel_for("update_p", nl, KOKKOS_LAMBDA(const int i) {
+                    p(i + 1) = r(i) + beta * p(i + 1);
+                });
+
+                rsold = rsnew;
+            }
+        }
+
+        Kokkos::fence();
+        auto end_time = std::chrono::high_resolution_clock::now();
+        double elapsed = std::chrono::duration<double>(end_time - start_time).count();
+        double compute_time = elapsed - comm_time;
+        double max_elapsed = 0.0, max_comm = 0.0, max_compute = 0.0;
+        MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&comm_time, &max_comm, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&compute_time, &max_compute, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+        // Gather the row blocks on rank 0 and output the solution
+        auto h_x = Kokkos::create_mirror_view(x);
+        Kokkos::deep_copy(h_x, x);
+        std::vector<int> counts(nranks), displs(nranks);
+        for (int q = 0; q < nranks; q++) {
+            counts[q] = base + (q < extra ? 1 : 0);
+            displs[q] = q * base + std::min(q, extra);
+        }
+        std::vector<double> x_global(rank == 0 ? n : 0);
+        MPI_Gatherv(h_x.data(), nl, MPI_DOUBLE, x_global.data(), counts.data(), displs.data(), MPI_DOUBLE, 0,
+                    MPI_COMM_WORLD);
+
+        if (rank == 0) {
+            for (int i = 0; i < n; i++) {
+                if (i < n - 1) {
+                    std::cout << std::fixed << std::setprecision(10) << x_global[i] << ",";
+                } else {
+                    std::cout << std::fixed << std::setprecision(10) << x_global[i] << std::endl;
+                }
+            }
+
+            std::cerr << "Ranks: " << nranks << std::endl;
+            std::cerr << "Time per iteration: " << std::fixed << std::setprecision(4)
+                      << max_elapsed / reps << " seconds" << std::endl;
+            std::cerr << "Communication time per iteration: " << std::fixed << std::setprecision(4)
+                      << max_comm / reps << " seconds" << std::endl;
+            std::cerr << "Compute time per iteration: " << std::fixed << std::setprecision(4)
+                      << max_compute / reps << " seconds" << std::endl;
+        }
+    }
+    Kokkos::finalize();
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+// Compressed coefficient forms for the Thomas solver.
+//
+// solve_tridiagonal_columns takes each of a, b and c as its own template
+// parameter and only calls m(i,k) on it, so a coefficient that does not vary
+// in i (or at all) can be passed in a form that reads nothing, or one value
+// per level, from memory instead of a full ni x nk View.  Since the solver
+// ignores a(i,0) and c(i,nk-1), off-diagonals that are constant apart from
+// zeroed end entries count as constant.
+
+#include <Kokkos_Core.hpp>
+
+#include "thomas_solver.hpp"
+
+// Same value in every column and level
+struct ConstantCoefficient {
+  double value;
+  KOKKOS_INLINE_FUNCTION double operator()(int, int) const { return value; }
+};
+
+// Vertical profile shared by all columns
+struct LevelCoefficient {
+  Kokkos::View<const double*, MemSpace, ReadOnlyTraits> profile;
+  KOKKOS_INLINE_FUNCTION double operator()(int, int k) const { return profile(k); }
+};
+
+// Full (column, level) coefficient, as before
+using FullCoefficient = Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits>;
@@ -0,0 +1,138 @@
+#pragma once
+// Variable column depth (bathymetry) for the Thomas solver.
+//
+// On a real ocean grid column i is wet on levels [k_low(i), k_high(i)) only,
+// with k counted down from the surface, and land columns have no wet levels.
+// The solver sweeps each column over its own wet levels; rows outside them are
+// never read and y there is left as it is.
+//
+// Solved in index order, shallow and deep columns share a team or warp and
+// the lanes of the shallow ones idle while the deep ones finish.
+// bin_columns_by_depth therefore sorts the wet columns into depth bins,
+// deepest first, so neighbouring lanes get columns of equal depth, and the
+// binned solve schedules teams dynamically: deep columns start first and the
+// shallow ones fill in behind them (longest job first).  Dry columns are not
+// in the list and cost nothing.
+//
+// The other column kernels (initialisation, coefficient assembly, ...) skip
+// land through WetColumns, a compacted index list of the wet columns that is
+// cached together with the depth bins and rebuilt only when the mask changes.
+
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <vector>
+
+#include "thomas_solver.hpp"
+
+struct ColumnDepth {
+  Kokkos::View<const int*, MemSpace> k_low;   // first wet level
+  Kokkos::View<const int*, MemSpace> k_high;  // one past the last wet level; <= k_low for land
+
+  KOKKOS_INLINE_FUNCTION int first(int i) const { return k_low(i); }
+  KOKKOS_INLINE_FUNCTION int last(int i) const { return k_high(i); }
+  KOKKOS_INLINE_FUNCTION int wet_levels(int i) const { return k_high(i) > k_low(i) ? k_high(i) - k_low(i) : 0; }
+};
+
+struct DepthBins {
+  int ni = 0, nk = 0;
+  Kokkos::View<int*, MemSpace> columns;  // wet columns, deepest bin first; order within a bin is unspecified
+  std::vector<int> bin_count;            // columns with d wet levels, d = 0..nk; bin_count[0] are dry
+
+  int wet_count() const { return int(columns.extent(0)); }
+  long wet_levels() const {
+    long levels = 0;
+    for (int d = 1; d <= nk; d++) levels += long(d) * bin_count[d];
+    return levels;
+  }
+};
+
+// Counting sort of the columns by wet depth: a histogram, the bin offsets
+// (deepest first) on the host, and an atomic scatter.  The histogram is read
+// back, so this waits for `exec`; rebuild the bins when the depths change.
+inline DepthBins bin_columns_by_depth(const ExecSpace& exec, int ni, int nk, const ColumnDepth& depth) {
+  DepthBins bins;
+  bins.ni = ni;
+  bins.nk = nk;
+
+  Kokkos::View<int*, MemSpace> counts("depth_bin_counts", nk + 1);
+  Kokkos::parallel_for("depth_histogram", Kokkos::RangePolicy<ExecSpace>(exec, 0, ni), KOKKOS_LAMBDA(const int i) {
+    Kokkos::atomic_increment(&counts(std::min(depth.wet_levels(i), nk)));
+  });
+  auto h_counts = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace{}, counts);
+  bins.bin_count.assign(h_counts.data(), h_counts.data() + nk + 1);
+
+  // Bin d starts after all deeper bins
+  auto h_offsets = Kokkos::create_mirror_view(counts);
+  int wet = 0;
+  h_offsets(0) = 0;
+  for (int d = nk; d >= 1; d--) {
+    h_offsets(d) = wet;
+    wet += bins.bin_count[d];
+  }
+  Kokkos::View<int*, MemSpace> cursor(Kokkos::view_alloc(Kokkos::WithoutInitializing, "depth_bin_cursor"), nk + 1);
+  Kokkos::deep_copy(exec, cursor, h_offsets);
+
+  bins.columns = Kokkos::View<int*, MemSpace>(Kokkos::view_alloc(Kokkos::WithoutInitializing, "depth_binned_columns"),
+                                              wet);
+  const auto columns = bins.columns;
+  Kokkos::parallel_for("depth_scatter", Kokkos::RangePolicy<ExecSpace>(exec, 0, ni), KOKKOS_LAMBDA(const int i) {
+    const int d = std::min(depth.wet_levels(i), nk);
+    if (d > 0) columns(Kokkos::atomic_fetch_add(&cursor(d), 1)) = i;
+  });
+  exec.fence("bin_columns_by_depth");
+  return bins;
+}
+
+// Solves the wet columns of `bins`, each over its own levels, with rows(i,k)
+// as in solve_tridiagonal_fused.  Asynchronous on `exec`, like
+// solve_tridiagonal_columns.
+template <class Accum = void, class Rows, class RhsView>
+void solve_tridiagonal_binned(const ExecSpace& exec, const DepthBins& bins, const ColumnDepth& depth, Rows rows,
+                              RhsView y, const tuning::LaunchParams& launch) {
+  if (bins.wet_count() == 0) return;
+  solve_tridiagonal_rows_impl<true, Accum, Kokkos::Schedule<Kokkos::Dynamic>>(
+      exec, bins.wet_count(), bins.nk, ColumnList{bins.columns}, depth, rows, y, launch);
+}
+
+// Same with stored coefficients.
+template <class Accum = void, class AView, class BView, class CView, class RhsView>
+void solve_tridiagonal_binned(const ExecSpace& exec, const DepthBins& bins, const ColumnDepth& depth, AView a, BView b,
+                              CView c, RhsView y, const tuning::LaunchParams& launch) {
+  solve_tridiagonal_binned<Accum>(exec, bins, depth, SeparateCoefficients<AView, BView, CView>{a, b, c}, y, launch);
+}
+
+// Wet columns of a ColumnDepth, cached across calls: `columns` in index order,
+// for kernels that visit every wet column (parallel_for_solver_columns with a
+// ColumnList keeps neighbouring threads on neighbouring columns), and the
+// depth bins for the solver.  update() rebuilds both only when the mask has
+// changed, i.e. for other depth Views or another mask version; callers bump
+// the version whenever they rewrite k_low / k_high in place (wetting and
+// drying, a new bathymetry).
+class WetColumns {
+ public:
+  // Returns true when the lists were rebuilt; waits for `exec` only then.
+  bool update(const ExecSpace& exec, int ni, int nk, const ColumnDepth& depth, int mask_version) {
+    if (m_rebuilds > 0 && ni == m_bins.ni && nk == m_bins.nk && mask_version == m_mask_version &&
+        depth.k_low.data() == m_depth.k_low.data() && depth.k_high.data() == m_depth.k_high.data()) {
+      return false;
+    }
+    m_depth = depth;
+    m_mask_version = mask_version;
+    m_columns = compact_columns("wet_columns", exec, ni, KOKKOS_LAMBDA(int i) { return depth.wet_levels(i) > 0; });
+    m_bins = bin_columns_by_depth(exec, ni, nk, depth);
+    m_rebuilds++;
+    return true;
+  }
+
+  int count() const { return int(m_columns.extent(0)); }
+  ColumnList columns() const { return ColumnList{m_columns}; }
+  const DepthBins& bins() const { return m_bins; }
+  int rebuilds() const { return m_rebuilds; }
+
+ private:
+  ColumnDepth m_depth;
+  int m_mask_version = 0;
+  Kokkos::View<int*, MemSpace> m_columns;
+  DepthBins m_bins;
+  int m_rebuilds = 0;
+};
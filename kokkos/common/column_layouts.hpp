@@ -0,0 +1,126 @@
+#pragma once
+// Storage layouts for the (column, level) solver arrays.
+//
+// solve_tridiagonal_columns only needs m(i,k), so each storage below plugs
+// straight into it.  Which one is fastest depends on how the launch maps
+// columns to threads: one column per team walks k within a thread and wants
+// k-contiguous storage (LayoutRight), many columns per team in lock step want
+// i-contiguous storage (LayoutLeft), and the blocked layout keeps a tile of
+// columns contiguous per level, which serves both.  The packed layout goes one
+// step further and interleaves a, b and c of a tile (AoSoA), so each level of
+// a tile is one contiguous run of 3 x kTileColumns coefficients instead of
+// three separate memory streams.
+//
+// Every storage provides Matrix (right hand side / solution), CoefMatrix and
+// ConstMatrix (coefficients, writable and read-only), allocate() for a Matrix
+// and allocate_coefficients() for a, b and c together.
+
+#include <Kokkos_Core.hpp>
+#include <array>
+
+#include "thomas_solver.hpp"
+
+// Columns grouped into tiles of TileColumns; each tile stores its levels one
+// after another with the tile's columns contiguous, i.e. (tile, k, column in
+// tile) in LayoutRight.  The last tile is padded.
+template <class T, int TileColumns>
+struct BlockedColumnMatrix {
+  Kokkos::View<T***, Kokkos::LayoutRight, MemSpace> tiles;
+
+  BlockedColumnMatrix() = default;
+  BlockedColumnMatrix(const char* label, int ni, int nk)
+      : tiles(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), (ni + TileColumns - 1) / TileColumns, nk,
+              TileColumns) {}
+  template <class U>
+  BlockedColumnMatrix(const BlockedColumnMatrix<U, TileColumns>& other) : tiles(other.tiles) {}
+
+  KOKKOS_INLINE_FUNCTION T& operator()(int i, int k) const {
+    return tiles(i / TileColumns, k, i % TileColumns);
+  }
+};
+
+// a, b, c of TileColumns columns interleaved per level: one allocation of
+// (tile, k, coefficient * TileColumns + column in tile) in LayoutRight, viewed
+// through three accessors that differ only in `coef` (0 = a, 1 = b, 2 = c).
+template <class T, int TileColumns>
+struct PackedColumnMatrix {
+  Kokkos::View<T***, Kokkos::LayoutRight, MemSpace> packed;
+  int offset = 0;  // coef * TileColumns
+
+  PackedColumnMatrix() = default;
+  PackedColumnMatrix(const Kokkos::View<T***, Kokkos::LayoutRight, MemSpace>& packed_, int coef)
+      : packed(packed_), offset(coef * TileColumns) {}
+  template <class U>
+  PackedColumnMatrix(const PackedColumnMatrix<U, TileColumns>& other) : packed(other.packed), offset(other.offset) {}
+
+  KOKKOS_INLINE_FUNCTION T& operator()(int i, int k) const {
+    return packed(i / TileColumns, k, offset + i % TileColumns);
+  }
+};
+
+// Columns per tile / SIMD block: one cache line of doubles (the AVX-512 double
+// width) on host backends, a warp on devices
+constexpr int kTileColumns = Kokkos::SpaceAccessibility<Kokkos::HostSpace, MemSpace>::accessible ? 8 : 32;
+
+// Copies a, b, c (any m(i,k) accessors) into the coefficient storage `dst`
+// with the solver's column partitioning; for PackedStorage this is the
+// SoA -> AoSoA pack kernel.
+template <class Coef, class A, class B, class C>
+void pack_coefficients(const ExecSpace& exec, int ni, int nk, A a, B b, C c, const std::array<Coef, 3>& dst) {
+  const Coef pa = dst[0], pb = dst[1], pc = dst[2];
+  parallel_for_solver_columns("pack_coefficients", exec, ni, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+    for (int k = 0; k < nk; k++) {
+      pa(i,k) = a(i,k);
+      pb(i,k) = b(i,k);
+      pc(i,k) = c(i,k);
+    }
+  });
+}
+
+template <class ViewLayout>
+struct ViewStorage {
+  using Matrix = Kokkos::View<double**, ViewLayout, MemSpace>;
+  using CoefMatrix = Matrix;
+  using ConstMatrix = Kokkos::View<const double**, ViewLayout, MemSpace, ReadOnlyTraits>;
+  static Matrix allocate(const char* label, int ni, int nk) {
+    return Matrix(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), ni, nk);
+  }
+  static std::array<CoefMatrix, 3> allocate_coefficients(int ni, int nk) {
+    return {allocate("a_layout", ni, nk), allocate("b_layout", ni, nk), allocate("c_layout", ni, nk)};
+  }
+};
+
+struct LeftStorage : ViewStorage<Kokkos::LayoutLeft> {
+  static constexpr const char* name = "left";
+};
+
+struct RightStorage : ViewStorage<Kokkos::LayoutRight> {
+  static constexpr const char* name = "right";
+};
+
+struct TiledStorage {
+  static constexpr const char* name = "tiled";
+  using Matrix = BlockedColumnMatrix<double, kTileColumns>;
+  using CoefMatrix = Matrix;
+  using ConstMatrix = BlockedColumnMatrix<const double, kTileColumns>;
+  static Matrix allocate(const char* label, int ni, int nk) { return Matrix(label, ni, nk); }
+  static std::array<CoefMatrix, 3> allocate_coefficients(int ni, int nk) {
+    return {allocate("a_layout", ni, nk), allocate("b_layout", ni, nk), allocate("c_layout", ni, nk)};
+  }
+};
+
+// AoSoA coefficients; y keeps the tiled layout so its tiles line up with the
+// coefficient blocks.
+struct PackedStorage {
+  static constexpr const char* name = "packed";
+  using Matrix = BlockedColumnMatrix<double, kTileColumns>;
+  using CoefMatrix = PackedColumnMatrix<double, kTileColumns>;
+  using ConstMatrix = PackedColumnMatrix<const double, kTileColumns>;
+  static Matrix allocate(const char* label, int ni, int nk) { return Matrix(label, ni, nk); }
+  static std::array<CoefMatrix, 3> allocate_coefficients(int ni, int nk) {
+    Kokkos::View<double***, Kokkos::LayoutRight, MemSpace> packed(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "abc_packed"), (ni + kTileColumns - 1) / kTileColumns, nk,
+        3 * kTileColumns);
+    return {CoefMatrix(packed, 0), CoefMatrix(packed, 1), CoefMatrix(packed, 2)};
+  }
+};
@@ -0,0 +1,156 @@
+#pragma once
+// Diagonal-dominance screening for the branch-free Thomas sweep.
+//
+// When every row of a column has |b| > |a| + |c| (a(i,0) and c(i,nk-1) count
+// as zero), every pivot of the Thomas recurrence is nonzero and the sweep
+// needs no zero-pivot check.  screen_columns runs that test once per
+// coefficient set and splits the columns into a dominant list, solved by the
+// unguarded sweep, and a rerouted list, solved by Gaussian elimination with
+// partial pivoting (the LAPACK gtsv recurrence).  Columns that are singular
+// even with pivoting are counted and get NaN solutions rather than the
+// silently zeroed ones of the guarded sweep.
+
+#include <Kokkos_Core.hpp>
+#include <cmath>
+
+#include "thomas_solver.hpp"
+
+struct ColumnScreen {
+  int ni = 0, nk = 0;
+  Kokkos::View<int*, MemSpace> dominant;  // solved by the branch-free sweep
+  Kokkos::View<int*, MemSpace> rerouted;  // solved with partial pivoting
+  Kokkos::View<double**, Kokkos::LayoutRight, MemSpace> work;  // pivoting workspace, one row per rerouted column
+  Kokkos::View<int*, MemSpace> singular;  // per rerouted column: singular even with pivoting in the last solve
+
+  int rerouted_count() const { return int(rerouted.extent(0)); }
+
+  // Singular columns found by the last solve (waits for it)
+  int singular_count() const {
+    const auto flags = singular;
+    int count = 0;
+    Kokkos::parallel_reduce("count_singular_columns", Kokkos::RangePolicy<ExecSpace>(0, rerouted_count()),
+      KOKKOS_LAMBDA(const int j, int& sum) { sum += flags(j); }, count);
+    return count;
+  }
+};
+
+template <class AView, class BView, class CView>
+ColumnScreen screen_columns(const ExecSpace& exec, int ni, int nk, AView a, BView b, CView c) {
+  ColumnScreen screen;
+  screen.ni = ni;
+  screen.nk = nk;
+  Kokkos::View<int*, MemSpace> dominant_flag(Kokkos::view_alloc(Kokkos::WithoutInitializing, "diagonally_dominant"),
+                                              ni);
+  // Branch-free per-column AND over the levels; the end rows are peeled so
+  // the k loop is a plain vectorisable reduction
+  parallel_for_solver_columns("check_diagonal_dominance", exec, ni, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+    using std::abs;
+    int ok;
+    if (nk == 1) {
+      ok = int(abs(double(b(i,0))) > 0.0);
+    } else {
+      ok = int(abs(double(b(i,0))) > abs(double(c(i,0)))) &
+           int(abs(double(b(i,nk-1))) > abs(double(a(i,nk-1))));
+    }
+    for (int k = 1; k < nk-1; k++) {
+      ok &= int(abs(double(b(i,k))) > abs(double(a(i,k))) + abs(double(c(i,k))));
+    }
+    dominant_flag(i) = ok;
+  });
+  screen.dominant = compact_columns("dominant_columns", exec, ni, KOKKOS_LAMBDA(int i) { return dominant_flag(i) != 0; });
+  screen.rerouted = compact_columns("rerouted_columns", exec, ni, KOKKOS_LAMBDA(int i) { return dominant_flag(i) == 0; });
+  screen.work = Kokkos::View<double**, Kokkos::LayoutRight, MemSpace>(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "pivoting_workspace"), screen.rerouted_count(), 3 * nk);
+  screen.singular = Kokkos::View<int*, MemSpace>("singular_columns", screen.rerouted_count());
+  return screen;
+}
+
+// Solves the rerouted columns of `screen` by Gaussian elimination with partial
+// pivoting, one thread per column.
+template <class AView, class BView, class CView, class RhsView>
+void solve_tridiagonal_pivoting(const ExecSpace& exec, const ColumnScreen& screen, AView a, BView b, CView c,
+                                RhsView y) {
+  const int nk = screen.nk;
+  const auto rerouted = screen.rerouted;
+  const auto work = screen.work;
+  const auto singular = screen.singular;
+  using value_type = std::remove_cv_t<std::remove_reference_t<decltype(y(0, 0))>>;
+  Kokkos::parallel_for("thomas_pivoting_fallback", Kokkos::RangePolicy<ExecSpace>(exec, 0, screen.rerouted_count()),
+    KOKKOS_LAMBDA(const int j) {
+      using std::abs;
+      const int i = rerouted(j);
+      // d: diagonal, du: first superdiagonal, dl: subdiagonal, which after
+      // elimination holds the second superdiagonal created by interchanges
+      double* d = &work(j, 0);
+      double* du = d + nk;
+      double* dl = du + nk;
+      for (int k = 0; k < nk; k++) {
+        d[k] = b(i,k);
+        du[k] = (k < nk-1) ? double(c(i,k)) : 0.0;
+        dl[k] = (k < nk-1) ? double(a(i,k+1)) : 0.0;
+      }
+      auto rhs = [&](int k) -> value_type& { return y(i,k); };
+
+      // Pivot tests are written as !(abs(p) > 0) so that NaN pivots fail too
+      bool ok = true;
+      for (int k = 0; k < nk-1; k++) {
+        if (abs(d[k]) >= abs(dl[k])) {
+          // No row interchange
+          if (!(abs(d[k]) > 0.0)) {
+            ok = false;
+            break;
+          }
+          const double fact = dl[k] / d[k];
+          d[k+1] -= fact * du[k];
+          rhs(k+1) = value_type(rhs(k+1) - fact * rhs(k));
+          dl[k] = 0.0;
+        } else {
+          // Interchange rows k and k+1; a NaN in d or dl also lands here
+          if (!(abs(dl[k]) > 0.0)) {
+            ok = false;
+            break;
+          }
+          const double fact = d[k] / dl[k];
+          d[k] = dl[k];
+          const double temp = d[k+1];
+          d[k+1] = du[k] - fact * temp;
+          if (k < nk-2) {
+            dl[k] = du[k+1];
+            du[k+1] = -fact * dl[k];
+          }
+          du[k] = temp;
+          const double r = rhs(k);
+          rhs(k) = rhs(k+1);
+          rhs(k+1) = value_type(r - fact * rhs(k+1));
+        }
+      }
+      if (ok && !(abs(d[nk-1]) > 0.0)) ok = false;
+      singular(j) = ok ? 0 : 1;
+      if (!ok) {
+        for (int k = 0; k < nk; k++) rhs(k) = value_type(NAN);
+        return;
+      }
+
+      // Back substitution with up to two superdiagonals
+      rhs(nk-1) = value_type(rhs(nk-1) / d[nk-1]);
+      if (nk > 1) rhs(nk-2) = value_type((rhs(nk-2) - du[nk-2] * rhs(nk-1)) / d[nk-2]);
+      for (int k = nk-3; k >= 0; k--) {
+        rhs(k) = value_type((rhs(k) - du[k] * rhs(k+1) - dl[k] * rhs(k+2)) / d[k]);
+      }
+    });
+}
+
+// Screened solve: the branch-free sweep on the dominant columns (all of them,
+// without an index list, when nothing was rerouted) and the pivoting
+// fallback on the rest.  Asynchronous on `exec`, like solve_tridiagonal_columns.
+template <class Accum = void, class AView, class BView, class CView, class RhsView>
+void solve_tridiagonal_screened(const ExecSpace& exec, const ColumnScreen& screen, AView a, BView b, CView c, RhsView y,
+                                const tuning::LaunchParams& launch) {
+  if (screen.rerouted_count() == 0) {
+    solve_tridiagonal_columns_impl<false, Accum>(exec, screen.ni, screen.nk, AllColumns{}, a, b, c, y, launch);
+    return;
+  }
+  solve_tridiagonal_columns_impl<false, Accum>(exec, int(screen.dominant.extent(0)), screen.nk,
+                                               ColumnList{screen.dominant}, a, b, c, y, launch);
+  solve_tridiagonal_pivoting(exec, screen, a, b, c, y);
+}
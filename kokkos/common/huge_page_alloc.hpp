@@ -0,0 +1,104 @@
+#pragma once
+// Huge-page backed host allocation for the large solver Views.
+//
+// The (column, level) arrays of the mitgcm drivers reach several GB, and the
+// k-strided sweeps of a team-per-column solver touch a new 4 KB page on nearly
+// every level, so TLB misses become visible.  An Arena hands out Views over
+// 2 MB aligned blocks, optionally advised with MADV_HUGEPAGE so transparent
+// huge pages back them even when THP is in "madvise" mode.
+//
+// The Views are unmanaged: the Arena owns the memory and must outlive them,
+// so declare it before the Views it allocates.  Memory is left untouched, like
+// a WithoutInitializing allocation, so the first write decides NUMA placement.
+// Device memory spaces are not affected; their drivers pick page sizes.
+
+#include <Kokkos_Core.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+
+namespace hugepage {
+
+constexpr std::size_t kHugePageBytes = std::size_t(2) << 20;
+
+// default: Kokkos allocation; aligned: 2 MB aligned blocks; hugepage: 2 MB
+// aligned blocks advised with MADV_HUGEPAGE
+enum class Mode { Default, Aligned, HugePage };
+
+inline bool parse_mode(const std::string& name, Mode& mode) {
+  if (name == "default") mode = Mode::Default;
+  else if (name == "aligned") mode = Mode::Aligned;
+  else if (name == "hugepage") mode = Mode::HugePage;
+  else return false;
+  return true;
+}
+
+inline const char* mode_name(Mode mode) {
+  switch (mode) {
+    case Mode::Aligned: return "aligned";
+    case Mode::HugePage: return "hugepage";
+    default: return "default";
+  }
+}
+
+// Anonymous memory of this process currently backed by transparent huge pages
+// (kB), or -1 where /proc/self/smaps_rollup is not available.
+inline long anon_huge_pages_kb() {
+  std::ifstream in("/proc/self/smaps_rollup");
+  std::string key;
+  long value = 0;
+  while (in >> key >> value) {
+    if (key == "AnonHugePages:") return value;
+    in.ignore(256, '\n');
+  }
+  return -1;
+}
+
+class Arena {
+ public:
+  explicit Arena(Mode mode) : m_mode(mode) {}
+  ~Arena() {
+    for (void* block : m_blocks) std::free(block);
+  }
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  Mode mode() const { return m_mode; }
+
+  // True when views of `ViewType` are served from the arena rather than by
+  // Kokkos: a non-default mode and a host-accessible memory space.
+  template <class ViewType>
+  bool serves() const {
+    return m_mode != Mode::Default &&
+           Kokkos::SpaceAccessibility<Kokkos::HostSpace, typename ViewType::memory_space>::accessible;
+  }
+
+  // n0 x n1 View for the arena's mode; falls back to a Kokkos allocation
+  // (WithoutInitializing) when the arena does not serve this View type.
+  template <class ViewType>
+  ViewType matrix(const char* label, int n0, int n1) {
+    if (!serves<ViewType>()) return ViewType(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), n0, n1);
+    using value_type = typename ViewType::non_const_value_type;
+    std::size_t bytes = std::size_t(n0) * std::size_t(n1) * sizeof(value_type);
+    bytes = (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+    if (bytes == 0) bytes = kHugePageBytes;
+    void* block = nullptr;
+    if (posix_memalign(&block, kHugePageBytes, bytes) != 0) throw std::bad_alloc();
+    m_blocks.push_back(block);
+#ifdef MADV_HUGEPAGE
+    // Advisory only: without THP support the block is still 2 MB aligned
+    if (m_mode == Mode::HugePage) madvise(block, bytes, MADV_HUGEPAGE);
+#endif
+    return ViewType(static_cast<value_type*>(block), n0, n1);
+  }
+
+ private:
+  Mode m_mode;
+  std::vector<void*> m_blocks;
+};
+
+}  // namespace hugepage
@@ -0,0 +1,258 @@
+#pragma once
+// Launch-parameter autotuning with a persistent on-disk cache.
+//
+// Kernels that expose a team size, vector length or chunk size ask a
+// LaunchTuner for their parameters by kernel name and problem size.  With
+// --tune every candidate is timed and the winner is written back to the cache
+// file; later runs load the cache at startup and reuse it.  Entries are keyed
+// by execution space, concurrency and CPU model as well, so one cache file can
+// be shared between machines with different SKUs.
+
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tuning {
+
+// A value of 0 means "not set": Kokkos::AUTO for team size / vector length and
+// the backend default for chunk size.
+struct LaunchParams {
+  int team_size = 0;
+  int vector_length = 0;
+  int chunk_size = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const LaunchParams& p) {
+  auto show = [&](const char* name, int v) {
+    os << name << "=";
+    if (v > 0) os << v; else os << "auto";
+  };
+  show("team_size", p.team_size);
+  os << " ";
+  show("vector_length", p.vector_length);
+  os << " ";
+  show("chunk_size", p.chunk_size);
+  return os;
+}
+
+// Extra policy traits (e.g. Kokkos::Schedule<Kokkos::Dynamic>) can be given
+// after the execution space: make_team_policy<ExecSpace, Traits...>(...).
+template <class ExecSpace, class... Traits>
+Kokkos::TeamPolicy<ExecSpace, Traits...> make_team_policy(const ExecSpace& exec, int league, const LaunchParams& p) {
+  using Policy = Kokkos::TeamPolicy<ExecSpace, Traits...>;
+  Policy policy =
+      (p.team_size > 0 && p.vector_length > 0) ? Policy(exec, league, p.team_size, p.vector_length)
+      : (p.team_size > 0)                      ? Policy(exec, league, p.team_size)
+      : (p.vector_length > 0)                  ? Policy(exec, league, Kokkos::AUTO, p.vector_length)
+                                               : Policy(exec, league, Kokkos::AUTO);
+  if (p.chunk_size > 0) policy.set_chunk_size(p.chunk_size);
+  return policy;
+}
+
+template <class ExecSpace>
+Kokkos::RangePolicy<ExecSpace> make_range_policy(const ExecSpace& exec, int begin, int end, const LaunchParams& p) {
+  Kokkos::RangePolicy<ExecSpace> policy(exec, begin, end);
+  if (p.chunk_size > 0) policy.set_chunk_size(p.chunk_size);
+  return policy;
+}
+
+// Execution space, concurrency and CPU model, with whitespace squeezed out so
+// the id is a single token in the cache file.
+inline std::string platform_id() {
+  std::string cpu = "unknown_cpu";
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("model name", 0) == 0) {
+      auto start = line.find_first_not_of(" \t:", line.find(':'));
+      if (start != std::string::npos) cpu = line.substr(start);
+      break;
+    }
+  }
+  std::string id = std::string(Kokkos::DefaultExecutionSpace::name()) + "/" +
+                   std::to_string(Kokkos::DefaultExecutionSpace().concurrency()) + "/" + cpu;
+  std::string out;
+  for (char ch : id) {
+    if (ch == ' ' || ch == '\t') {
+      if (!out.empty() && out.back() != '_') out += '_';
+    } else {
+      out += ch;
+    }
+  }
+  while (!out.empty() && out.back() == '_') out.pop_back();
+  return out;
+}
+
+// Candidate grids.  Team sizes stop at the concurrency of the execution space
+// (and at 1024, the largest team any backend accepts).
+inline std::vector<LaunchParams> team_candidates(int max_team) {
+  std::vector<int> chunks = {0, 1, 4, 16, 64};
+  std::vector<LaunchParams> out;
+  for (int team = 1; team <= max_team && team <= 1024; team *= 2) {
+    for (int vector = 1; vector <= 8 && team * vector <= 1024; vector *= 2) {
+      for (int chunk : chunks) out.push_back({team, vector, chunk});
+    }
+  }
+  return out;
+}
+
+inline std::vector<LaunchParams> chunk_candidates() {
+  std::vector<LaunchParams> out;
+  for (int chunk : {0, 64, 256, 1024, 4096, 16384, 65536}) out.push_back({0, 0, chunk});
+  return out;
+}
+
+class LaunchTuner {
+ public:
+  // Recognises --tune and --tuning-cache <path>; the cache path can also be
+  // set through KOKKOS_TUNING_CACHE.
+  static LaunchTuner from_args(int argc, char* argv[]) {
+    LaunchTuner t;
+    if (const char* env = std::getenv("KOKKOS_TUNING_CACHE")) t.m_path = env;
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg == "--tune") {
+        t.m_tune = true;
+      } else if (arg == "--tuning-cache" && i + 1 < argc) {
+        t.m_path = argv[++i];
+      }
+    }
+    t.m_platform = platform_id();
+    t.load();
+    return t;
+  }
+
+  bool tuning() const { return m_tune; }
+
+  // Returns the launch parameters for `kernel` at `problem_size`.  In tuning
+  // mode every candidate is timed through `run` (which must execute the
+  // kernel once) and the fastest one is cached; otherwise the cached entry for
+  // the nearest problem size on this platform is used, falling back to
+  // `defaults` when the kernel has never been tuned here.
+  template <class Run>
+  LaunchParams select(const std::string& kernel, long problem_size, const LaunchParams& defaults,
+                      const std::vector<LaunchParams>& candidates, Run&& run, int reps = 3) {
+    if (m_tune) {
+      LaunchParams best = defaults;
+      double best_time = time_candidate(run, defaults, reps);
+      for (const auto& p : candidates) {
+        double t = time_candidate(run, p, reps);
+        if (t < best_time) {
+          best_time = t;
+          best = p;
+        }
+      }
+      store(kernel, problem_size, best, best_time);
+      save();
+      std::cerr << "Tuned " << kernel << " (n=" << problem_size << "): " << best << " (" << std::scientific
+                << std::setprecision(3) << best_time << " s)" << std::defaultfloat << std::endl;
+      return best;
+    }
+
+    const Entry* e = nearest(kernel, problem_size);
+    if (e == nullptr) return defaults;
+    std::cerr << "Cached launch params for " << kernel << " (n=" << e->problem_size << "): " << e->params
+              << std::endl;
+    return e->params;
+  }
+
+ private:
+  struct Entry {
+    std::string kernel;
+    long problem_size;
+    std::string platform;
+    LaunchParams params;
+    double seconds;
+  };
+
+  template <class Run>
+  static double time_candidate(Run& run, const LaunchParams& p, int reps) {
+    double best = std::numeric_limits<double>::infinity();
+    try {
+      run(p);  // warmup; also rejects configurations the backend cannot launch
+      Kokkos::fence();
+      for (int r = 0; r < reps; ++r) {
+        auto start = std::chrono::high_resolution_clock::now();
+        run(p);
+        Kokkos::fence();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+      }
+    } catch (const std::exception& ex) {
+      std::cerr << "Skipping " << p << ": " << ex.what() << std::endl;
+    }
+    return best;
+  }
+
+  void load() {
+    std::ifstream in(m_path);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      std::istringstream ss(line);
+      Entry e;
+      if (ss >> e.kernel >> e.problem_size >> e.platform >> e.params.team_size >> e.params.vector_length >>
+          e.params.chunk_size >> e.seconds) {
+        m_entries.push_back(e);
+      }
+    }
+  }
+
+  void save() const {
+    std::ofstream out(m_path);
+    if (!out) {
+      std::cerr << "Warning: cannot write tuning cache " << m_path << std::endl;
+      return;
+    }
+    out << "# kernel problem_size platform team_size vector_length chunk_size seconds\n";
+    for (const auto& e : m_entries) {
+      out << e.kernel << " " << e.problem_size << " " << e.platform << " " << e.params.team_size << " "
+          << e.params.vector_length << " " << e.params.chunk_size << " " << std::scientific << std::setprecision(6)
+          << e.seconds << std::defaultfloat << "\n";
+    }
+  }
+
+  void store(const std::string& kernel, long problem_size, const LaunchParams& p, double seconds) {
+    for (auto& e : m_entries) {
+      if (e.kernel == kernel && e.problem_size == problem_size && e.platform == m_platform) {
+        e.params = p;
+        e.seconds = seconds;
+        return;
+      }
+    }
+    m_entries.push_back({kernel, problem_size, m_platform, p, seconds});
+  }
+
+  // Closest problem size in log space, so a cache tuned at 1M columns is still
+  // preferred over the defaults at 2M.
+  const Entry* nearest(const std::string& kernel, long problem_size) const {
+    const Entry* best = nullptr;
+    double best_dist = std::numeric_limits<double>::infinity();
+    for (const auto& e : m_entries) {
+      if (e.kernel != kernel || e.platform != m_platform) continue;
+      double dist = std::abs(std::log(double(e.problem_size)) - std::log(double(problem_size)));
+      if (dist < best_dist) {
+        best_dist = dist;
+        best = &e;
+      }
+    }
+    return best;
+  }
+
+  bool m_tune = false;
+  std::string m_path = "kokkos_tuning.cache";
+  std::string m_platform;
+  std::vector<Entry> m_entries;
+};
+
+}  // namespace tuning
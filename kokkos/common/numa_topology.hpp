@@ -0,0 +1,95 @@
+#pragma once
+// Host NUMA topology report for the CPU backends.
+//
+// First-touch placement only helps when every thread stays on the core (and
+// socket) it first touched its pages from, so the drivers print the NUMA nodes
+// found in sysfs together with the OpenMP binding in effect at startup, and
+// recommend OMP_PROC_BIND / OMP_PLACES settings when threads are left
+// unbound.
+
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace numa {
+
+struct Node {
+  int id;
+  std::string cpulist;  // as in sysfs, e.g. "0-15,32-47"
+  int ncpus;
+};
+
+// Number of CPUs in a sysfs cpulist such as "0-3,8,10-11".
+inline int count_cpus(const std::string& cpulist) {
+  int count = 0;
+  std::stringstream ss(cpulist);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) continue;
+    const auto dash = range.find('-');
+    if (dash == std::string::npos) {
+      count++;
+    } else {
+      count += std::atoi(range.c_str() + dash + 1) - std::atoi(range.c_str()) + 1;
+    }
+  }
+  return count;
+}
+
+// NUMA nodes with at least one CPU, in id order; empty when sysfs is not
+// available (non-Linux hosts, restricted containers).
+inline std::vector<Node> detect_nodes() {
+  std::vector<Node> nodes;
+  DIR* dir = opendir("/sys/devices/system/node");
+  if (dir == nullptr) return nodes;
+  while (dirent* entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+        name.find_first_not_of("0123456789", 4) != std::string::npos) {
+      continue;
+    }
+    std::ifstream in("/sys/devices/system/node/" + name + "/cpulist");
+    std::string cpulist;
+    if (!std::getline(in, cpulist) || cpulist.empty()) continue;
+    nodes.push_back({std::atoi(name.c_str() + 4), cpulist, count_cpus(cpulist)});
+  }
+  closedir(dir);
+  std::sort(nodes.begin(), nodes.end(), [](const Node& x, const Node& y) { return x.id < y.id; });
+  return nodes;
+}
+
+// Prints the topology and OpenMP binding to `os`.  Nothing is printed for
+// device backends, whose Views are not placed by host threads.
+inline void report_topology(std::ostream& os) {
+  if (!Kokkos::SpaceAccessibility<Kokkos::DefaultExecutionSpace, Kokkos::HostSpace>::accessible) return;
+
+  const auto nodes = detect_nodes();
+  int ncpus = 0;
+  for (const auto& node : nodes) ncpus += node.ncpus;
+  os << "NUMA nodes: " << (nodes.empty() ? 1 : int(nodes.size()));
+  if (!nodes.empty()) os << " (" << ncpus << " CPUs)";
+  os << ", execution space concurrency: " << Kokkos::DefaultExecutionSpace().concurrency() << "\n";
+  for (const auto& node : nodes) {
+    os << "  node " << node.id << ": CPUs " << node.cpulist << "\n";
+  }
+
+  const char* bind = std::getenv("OMP_PROC_BIND");
+  const char* places = std::getenv("OMP_PLACES");
+  os << "OMP_PROC_BIND=" << (bind ? bind : "(unset)") << " OMP_PLACES=" << (places ? places : "(unset)") << "\n";
+  if (bind == nullptr || std::string(bind) == "false" || places == nullptr) {
+    // spread places consecutive thread ids, and with them consecutive column
+    // blocks, on consecutive cores across all sockets
+    os << "Recommended: export OMP_PROC_BIND=spread OMP_PLACES=threads";
+    if (nodes.size() > 1) os << " (threads must stay on their socket for first-touch placement to hold)";
+    os << "\n";
+  }
+  os.flush();
+}
+
+}  // namespace numa
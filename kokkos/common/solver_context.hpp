@@ -0,0 +1,150 @@
+#pragma once
+// Long-lived Thomas solver context.
+//
+// Keeps the Kokkos runtime (and with it the backend thread pool), an
+// execution space instance, the launch parameters and the device workspace
+// alive across many solves, so per-call cost is only the solve itself.  Used
+// by the C/Fortran interface and by the mitgcm solver server.
+
+#include <Kokkos_Core.hpp>
+#include <chrono>
+
+#include "thomas_solver.hpp"
+
+class ThomasSolverContext {
+ public:
+  // Initializes Kokkos if the application has not; the runtime is finalized
+  // with the context only in that case.
+  explicit ThomasSolverContext(const tuning::LaunchParams& launch = {}) : m_launch(launch) {}
+
+  ThomasSolverContext(const ThomasSolverContext&) = delete;
+  ThomasSolverContext& operator=(const ThomasSolverContext&) = delete;
+
+  const ExecSpace& exec() const { return m_exec; }
+  const tuning::LaunchParams& launch() const { return m_launch; }
+  void set_launch(const tuning::LaunchParams& launch) { m_launch = launch; }
+
+  // Spins up the thread pool and, on device backends, first-touches the
+  // workspace for ni x nk problems with the solver's column partitioning, so
+  // the first real request does not pay for either.  Host backends solve the
+  // caller's arrays in place and never use the workspace, so they only launch
+  // an empty kernel with the solver's team shape.
+  void warm_up(int ni, int nk) {
+    if constexpr (Kokkos::SpaceAccessibility<Kokkos::HostSpace, MemSpace>::accessible) {
+      parallel_for_solver_columns("ThomasSolverContext::spin_up", m_exec, ni, m_launch, KOKKOS_LAMBDA(int) {});
+      m_exec.fence("ThomasSolverContext::warm_up");
+      return;
+    }
+    reserve(ni, nk);
+    auto a = m_a, b = m_b, c = m_c, y = m_y;
+    parallel_for_solver_columns("ThomasSolverContext::first_touch", m_exec, ni, m_launch, KOKKOS_LAMBDA(int i) {
+      for (int k = 0; k < nk; k++) {
+        a(i,k) = 0.0;
+        b(i,k) = 1.0;
+        c(i,k) = 0.0;
+        y(i,k) = 0.0;
+      }
+    });
+    solve(ni, nk, const_view(m_a), const_view(m_b), const_view(m_c), m_y);
+    m_exec.fence("ThomasSolverContext::warm_up");
+  }
+
+  // Solves Views that already live in MemSpace on the context's instance;
+  // asynchronous, like the other instance-based solver entry points.
+  template <class MatrixView, class RhsView>
+  void solve(int ni, int nk, MatrixView a, MatrixView b, MatrixView c, RhsView y) {
+    solve_tridiagonal_columns(m_exec, ni, nk, AllColumns{}, a, b, c, y, m_launch);
+    m_solves++;
+  }
+
+  // Solves host arrays with element (i,k) at [i*stride_i + k*stride_k] in
+  // place and waits for completion.  Host backends work on the arrays
+  // directly; device backends copy through the cached workspace, which is
+  // reallocated only when the problem shape changes.
+  void solve_host(int ni, int nk, const double* a, const double* b, const double* c, double* y, long stride_i,
+                  long stride_k) {
+    solve_host_impl<ExecSpace>(ni, nk, a, b, c, y, stride_i, stride_k);
+    m_exec.fence("ThomasSolverContext::solve_host");
+  }
+
+  void fence() const { m_exec.fence("ThomasSolverContext"); }
+
+  long solves() const { return m_solves; }
+  // Time spent starting the Kokkos runtime (zero if it was already running).
+  double startup_seconds() const { return m_runtime.seconds; }
+
+ private:
+  using Matrix = Kokkos::View<double**, Layout, MemSpace>;
+  using ConstMatrix = Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits>;
+
+  // Declared first so it is constructed before the execution space instance
+  // and destroyed last, after every View member.
+  struct Runtime {
+    bool owned = false;
+    double seconds = 0.0;
+    Runtime() {
+      if (!Kokkos::is_initialized()) {
+        auto start = std::chrono::high_resolution_clock::now();
+        Kokkos::initialize();
+        owned = true;
+        seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+      }
+    }
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+    ~Runtime() {
+      if (owned && Kokkos::is_initialized()) Kokkos::finalize();
+    }
+  };
+
+  static ConstMatrix const_view(const Matrix& m) { return ConstMatrix(m); }
+
+  void reserve(int ni, int nk) {
+    if (int(m_a.extent(0)) == ni && int(m_a.extent(1)) == nk) return;
+    auto alloc = [&](const char* label) { return Matrix(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), ni, nk); };
+    m_a = alloc("ctx_a");
+    m_b = alloc("ctx_b");
+    m_c = alloc("ctx_c");
+    m_y = alloc("ctx_y");
+  }
+
+  // Templated on the execution space so only the branch that applies to the
+  // enabled backend is instantiated.
+  template <class Space>
+  void solve_host_impl(int ni, int nk, const double* a, const double* b, const double* c, double* y, long stride_i,
+                       long stride_k) {
+    if constexpr (Kokkos::SpaceAccessibility<Space, Kokkos::HostSpace>::accessible) {
+      solve_tridiagonal_kokkos_strided(m_exec, ni, nk, a, b, c, y, stride_i, stride_k, m_launch);
+      m_solves++;
+    } else {
+      using HostStrided = Kokkos::View<double**, Kokkos::LayoutStride, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+      using HostConstStrided =
+          Kokkos::View<const double**, Kokkos::LayoutStride, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+      const Kokkos::LayoutStride layout(ni, stride_i, nk, stride_k);
+      reserve(ni, nk);
+      if (int(m_host.extent(0)) != ni || int(m_host.extent(1)) != nk) {
+        m_host = Kokkos::create_mirror_view(Kokkos::WithoutInitializing, m_a);
+      }
+      auto upload = [&](const double* p, const Matrix& d) {
+        Kokkos::deep_copy(m_host, HostConstStrided(p, layout));
+        Kokkos::deep_copy(m_exec, d, m_host);
+        m_exec.fence("ThomasSolverContext::upload");
+      };
+      upload(a, m_a);
+      upload(b, m_b);
+      upload(c, m_c);
+      upload(y, m_y);
+      solve(ni, nk, const_view(m_a), const_view(m_b), const_view(m_c), m_y);
+      Kokkos::deep_copy(m_exec, m_host, m_y);
+      m_exec.fence("ThomasSolverContext::download");
+      Kokkos::deep_copy(HostStrided(y, layout), m_host);
+    }
+  }
+
+  Runtime m_runtime;
+  ExecSpace m_exec;
+  tuning::LaunchParams m_launch;
+  Matrix m_a, m_b, m_c, m_y;
+  Matrix::HostMirror m_host;
+  long m_solves = 0;
+};
@@ -0,0 +1,372 @@
+#pragma once
+// Batched Thomas solver for independent tridiagonal systems, one per column,
+// shared by the mitgcm drivers.  Views are (column, level) with LayoutLeft by
+// default; column_layouts.hpp has the LayoutRight and tiled alternatives.
+
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "launch_tuning.hpp"
+
+// Optimized memory layout and traits for GPU performance
+using Layout = Kokkos::LayoutLeft;  // Explicit layout for coalesced access
+using MemSpace = Kokkos::DefaultExecutionSpace::memory_space;
+using ExecSpace = Kokkos::DefaultExecutionSpace;
+
+// Memory traits for read-only data (enables texture cache on GPU)
+using ReadOnlyTraits = Kokkos::MemoryTraits<Kokkos::RandomAccess>;
+
+// Profiling stubs for compatibility
+inline void pushRegion(const char*) {}
+inline void popRegion() {}
+
+// Column selections for the solver: every column 0..n-1, or the columns named
+// in a device index list (e.g. the interior or boundary of a tile).
+struct AllColumns {
+  KOKKOS_INLINE_FUNCTION int operator()(int idx) const { return idx; }
+};
+
+struct ColumnRange {
+  int begin;
+  KOKKOS_INLINE_FUNCTION int operator()(int idx) const { return begin + idx; }
+};
+
+struct ColumnList {
+  Kokkos::View<const int*, MemSpace> cols;
+  KOKKOS_INLINE_FUNCTION int operator()(int idx) const { return cols(idx); }
+};
+
+// Columns i in [0, ni) with pred(i), in increasing order, compacted with a
+// parallel_scan.  The returned View holds exactly the selected columns; the
+// scan total is read back, so this waits for `exec`.
+template <class Pred>
+Kokkos::View<int*, MemSpace> compact_columns(const char* label, const ExecSpace& exec, int ni, Pred pred) {
+  Kokkos::View<int*, MemSpace> list(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), ni);
+  int count = 0;
+  Kokkos::parallel_scan(label, Kokkos::RangePolicy<ExecSpace>(exec, 0, ni),
+    KOKKOS_LAMBDA(const int i, int& offset, const bool final) {
+      if (pred(i)) {
+        if (final) list(offset) = i;
+        offset++;
+      }
+    }, count);
+  return Kokkos::subview(list, Kokkos::make_pair(0, count));
+}
+
+// Column-to-team mapping of the solver kernel.  Each team owns team_threads x
+// vector_lanes columns; with AUTO launch parameters this is the original
+// one-column-per-team mapping.
+struct ColumnTiling {
+  int team_threads, vector_lanes, cols_per_team, league;
+  ColumnTiling(int ni, const tuning::LaunchParams& launch)
+      : team_threads(launch.team_size > 0 ? launch.team_size : 1),
+        vector_lanes(launch.vector_length > 0 ? launch.vector_length : 1),
+        cols_per_team(team_threads * vector_lanes),
+        league((ni + cols_per_team - 1) / cols_per_team) {}
+};
+
+// Runs f(i) for every column 0..ni-1 with the column-to-thread mapping of the
+// solver kernel under `launch`.  Initialising solver arrays through it, after
+// allocating them WithoutInitializing, places each page on the NUMA node of
+// the thread that later solves those columns; Kokkos' own zero fill and
+// MDRange init kernels split the arrays along the span instead, so on
+// multi-socket hosts whole levels end up on one socket.
+//
+// With a ColumnMap f runs for map(0..ni-1) instead, e.g. only the wet columns
+// of a ColumnList.
+template <class ColumnMap, class F>
+void parallel_for_solver_columns(const char* label, const ExecSpace& exec, int ni, ColumnMap map,
+                                 const tuning::LaunchParams& launch, F f) {
+  const ColumnTiling tiling(ni, launch);
+  const int team_threads = tiling.team_threads;
+  const int vector_lanes = tiling.vector_lanes;
+  const int cols_per_team = tiling.cols_per_team;
+  Kokkos::parallel_for(label, tuning::make_team_policy(exec, tiling.league, launch),
+    KOKKOS_LAMBDA(const Kokkos::TeamPolicy<ExecSpace>::member_type& team) {
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(team, team_threads), [&](const int t) {
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(team, vector_lanes), [&](const int v) {
+          const int idx = team.league_rank() * cols_per_team + t * vector_lanes + v;
+          if (idx < ni) f(map(idx));
+        });
+      });
+    });
+}
+
+template <class F>
+void parallel_for_solver_columns(const char* label, const ExecSpace& exec, int ni,
+                                 const tuning::LaunchParams& launch, F f) {
+  parallel_for_solver_columns(label, exec, ni, AllColumns{}, launch, f);
+}
+
+// One row (sub-, main and superdiagonal) of a tridiagonal system.
+template <class T>
+struct TridiagonalRow {
+  T a, b, c;
+};
+
+// Levels of every column: all nk of them.  column_depth.hpp has per-column
+// wet level ranges for variable bathymetry.
+struct FullDepth {
+  int nk;
+  KOKKOS_INLINE_FUNCTION int first(int) const { return 0; }
+  KOKKOS_INLINE_FUNCTION int last(int) const { return nk; }
+};
+
+// Row accessor over three separate coefficient accessors; the a, b, c entry
+// points below wrap their arguments in it.
+template <class AView, class BView, class CView>
+struct SeparateCoefficients {
+  using value_type = std::common_type_t<std::decay_t<decltype(std::declval<AView>()(0, 0))>,
+                                        std::decay_t<decltype(std::declval<BView>()(0, 0))>,
+                                        std::decay_t<decltype(std::declval<CView>()(0, 0))>>;
+  AView a;
+  BView b;
+  CView c;
+  KOKKOS_INLINE_FUNCTION TridiagonalRow<value_type> operator()(int i, int k) const {
+    return {a(i,k), b(i,k), c(i,k)};
+  }
+};
+
+// Solves the systems of the `ni` columns map(0..ni-1) on `exec`.  Nothing is
+// fenced; callers order work through the execution space instance.  The
+// coefficients come from rows(i,k), which returns a TridiagonalRow: either
+// SeparateCoefficients over stored a, b, c, or a functor that computes the
+// row on the fly from model fields (see solve_tridiagonal_fused).  Rows are
+// evaluated once each, in increasing k, during the forward sweep, before any
+// y(i,.) of the column is written.
+//
+// Each column is solved over its levels [levels.first(i), levels.last(i)),
+// which are all nk levels for FullDepth; a and c of the first and last of
+// them do not affect the solution, and columns without levels are skipped.
+//
+// The sweeps accumulate in `Accum`, by default the value type of y; e.g.
+// solve_tridiagonal_columns<double>(...) on float Views stores in fp32 and
+// computes in fp64.
+//
+// Guarded sweeps zero a column's solution from a zero pivot on, like the
+// Fortran reference; unguarded sweeps have no branch in the k loop and are
+// only safe on columns screened by column_screening.hpp.
+//
+// Teams are scheduled according to `Schedule`; the default static schedule
+// gives every thread the same contiguous block of columns on every call.
+template <bool Guarded, class Accum, class Schedule = Kokkos::Schedule<Kokkos::Static>, class ColumnMap,
+          class Levels, class Rows, class RhsView>
+void solve_tridiagonal_rows_impl(const ExecSpace& exec, int ni, int nk, ColumnMap map, Levels levels, Rows rows,
+                                 RhsView y, const tuning::LaunchParams& launch) {
+  using value_type = std::remove_cv_t<std::remove_reference_t<decltype(y(0, 0))>>;
+  using accum_type = std::conditional_t<std::is_void_v<Accum>, value_type, Accum>;
+  
+  pushRegion("thomas_solver_optimized");
+  
+  const ColumnTiling tiling(ni, launch);
+  const int team_threads = tiling.team_threads;
+  const int vector_lanes = tiling.vector_lanes;
+  const int cols_per_team = tiling.cols_per_team;
+  
+  // Single TeamPolicy kernel with scratch memory - eliminates O(nk) launch overhead
+  auto policy = tuning::make_team_policy<ExecSpace, Schedule>(exec, tiling.league, launch);
+  
+  // Allocate scratch memory for temporaries (c_prime, y_prime), interleaved by
+  // column so neighbouring vector lanes touch neighbouring addresses
+  const size_t scratch_bytes = 2 * nk * cols_per_team * sizeof(accum_type);
+  policy.set_scratch_size(0, Kokkos::PerTeam(scratch_bytes));
+  
+  Kokkos::parallel_for("thomas_algorithm_single_kernel", policy,
+    KOKKOS_LAMBDA(const typename Kokkos::TeamPolicy<ExecSpace, Schedule>::member_type& team) {
+      
+      // Get scratch memory for this team
+      accum_type* c_prime = (accum_type*)team.team_scratch(0).get_shmem(scratch_bytes);
+      accum_type* y_prime = c_prime + nk * cols_per_team;
+      
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(team, team_threads), [&](const int t) {
+        Kokkos::parallel_for(Kokkos::ThreadVectorRange(team, vector_lanes), [&](const int v) {
+          const int col = t * vector_lanes + v;
+          const int idx = team.league_rank() * cols_per_team + col;
+          if (idx >= ni) return;
+          const int i = map(idx);
+          const int k_first = levels.first(i);
+          const int k_last = levels.last(i);
+          if (k_first >= k_last) return;
+          
+          // Forward sweep - first element
+          const auto row0 = rows(i,k_first);
+          const accum_type b0 = row0.b;
+          if (!Guarded || b0 != accum_type(0)) {
+            accum_type recVar = accum_type(1) / b0;
+            c_prime[k_first * cols_per_team + col] = accum_type(row0.c) * recVar;
+            y_prime[k_first * cols_per_team + col] = accum_type(y(i,k_first)) * recVar;
+          } else {
+            c_prime[k_first * cols_per_team + col] = 0;
+            y_prime[k_first * cols_per_team + col] = 0;
+          }
+          
+          // Forward sweep - sequential k-loop within team (no kernel launch overhead)
+          for (int k = k_first + 1; k < k_last; k++) {
+            const int kc = k * cols_per_team + col;
+            const int km = kc - cols_per_team;
+            const auto row = rows(i,k);
+            const accum_type a_k = row.a;
+            accum_type tmpVar = accum_type(row.b) - a_k * c_prime[km];
+            if constexpr (Guarded) {
+              if (tmpVar != accum_type(0)) {
+                accum_type recVar = accum_type(1) / tmpVar;
+                c_prime[kc] = accum_type(row.c) * recVar;
+                y_prime[kc] = (accum_type(y(i,k)) - a_k * y_prime[km]) * recVar;
+              } else {
+                c_prime[kc] = 0;
+                y_prime[kc] = 0;
+              }
+            } else {
+              accum_type recVar = accum_type(1) / tmpVar;
+              c_prime[kc] = accum_type(row.c) * recVar;
+              y_prime[kc] = (accum_type(y(i,k)) - a_k * y_prime[km]) * recVar;
+            }
+          }
+          
+          // Backward sweep - last element; the running value stays in
+          // accum_type rather than being re-read from y
+          accum_type next = y_prime[(k_last-1) * cols_per_team + col];
+          y(i,k_last-1) = value_type(next);
+          
+          // Backward sweep - sequential k-loop within team
+          for (int k = k_last-2; k >= k_first; k--) {
+            const int kc = k * cols_per_team + col;
+            next = y_prime[kc] - c_prime[kc] * next;
+            y(i,k) = value_type(next);
+          }
+        });
+      });
+    }
+  );
+  
+  popRegion();
+}
+
+// Separate a, b, c: any rank-2 (column, level) Views in MemSpace, whatever
+// their layout, and each coefficient may also be a compressed form from
+// coefficient_views.hpp (constant or level-only), which the kernel is
+// specialised on at compile time.
+template <bool Guarded, class Accum, class ColumnMap, class AView, class BView, class CView, class RhsView>
+void solve_tridiagonal_columns_impl(const ExecSpace& exec, int ni, int nk, ColumnMap map,
+                                    AView a, BView b, CView c, RhsView y,
+                                    const tuning::LaunchParams& launch) {
+  solve_tridiagonal_rows_impl<Guarded, Accum>(exec, ni, nk, map, FullDepth{nk},
+                                              SeparateCoefficients<AView, BView, CView>{a, b, c}, y, launch);
+}
+
+template <class Accum = void, class ColumnMap, class AView, class BView, class CView, class RhsView>
+void solve_tridiagonal_columns(const ExecSpace& exec, int ni, int nk, ColumnMap map,
+                               AView a, BView b, CView c, RhsView y,
+                               const tuning::LaunchParams& launch) {
+  solve_tridiagonal_columns_impl<true, Accum>(exec, ni, nk, map, a, b, c, y, launch);
+}
+
+// Fused coefficient assembly: rows(i,k) computes the row from whatever the
+// coefficients derive from (diffusivity, layer thickness, time step, ...)
+// inside the sweep, so a, b and c are never written to memory and read back;
+// only the functor's inputs and y are streamed.  The functor may read y(i,.)
+// of its own column, which is still the right hand side while rows are
+// evaluated.
+template <class Accum = void, class ColumnMap, class Rows, class RhsView>
+void solve_tridiagonal_fused(const ExecSpace& exec, int ni, int nk, ColumnMap map, Rows rows, RhsView y,
+                             const tuning::LaunchParams& launch) {
+  solve_tridiagonal_rows_impl<true, Accum>(exec, ni, nk, map, FullDepth{nk}, rows, y, launch);
+}
+
+inline void solve_tridiagonal_kokkos_optimized(int ni, int nk,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> a,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> b,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> c,
+                                              Kokkos::View<double**, Layout, MemSpace> y,
+                                              const tuning::LaunchParams& launch = {}) {
+  solve_tridiagonal_columns(ExecSpace(), ni, nk, AllColumns{}, a, b, c, y, launch);
+}
+
+// Asynchronous form: enqueues the solve on `exec` and returns.  Completion is
+// observed through exec.fence() or by later work on the same instance.
+inline void solve_tridiagonal_kokkos_optimized(const ExecSpace& exec, int ni, int nk,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> a,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> b,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> c,
+                                              Kokkos::View<double**, Layout, MemSpace> y,
+                                              const tuning::LaunchParams& launch = {}) {
+  solve_tridiagonal_columns(exec, ni, nk, AllColumns{}, a, b, c, y, launch);
+}
+
+// Subset of columns on an execution space instance, e.g. the tile interior
+// while halo messages for the boundary are still in flight.
+inline void solve_tridiagonal_kokkos_optimized(const ExecSpace& exec, Kokkos::View<const int*, MemSpace> columns,
+                                              int nk,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> a,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> b,
+                                              Kokkos::View<const double**, Layout, MemSpace, ReadOnlyTraits> c,
+                                              Kokkos::View<double**, Layout, MemSpace> y,
+                                              const tuning::LaunchParams& launch = {}) {
+  solve_tridiagonal_columns(exec, int(columns.extent(0)), nk, ColumnList{columns}, a, b, c, y, launch);
+}
+
+// Unmanaged views over application arrays with arbitrary element strides
+// between columns and between levels (column-major, row-major, padded
+// leading dimension, ...).
+using StridedConstMatrix =
+    Kokkos::View<const double**, Kokkos::LayoutStride, MemSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess>>;
+using StridedMatrix = Kokkos::View<double**, Kokkos::LayoutStride, MemSpace, Kokkos::MemoryUnmanaged>;
+
+// Zero-copy entry point for host models: element (i,k) of each array is at
+// ptr[i*stride_i + k*stride_k].  The pointers must be accessible from
+// MemSpace; nothing is allocated or copied and y is solved in place on `exec`.
+inline void solve_tridiagonal_kokkos_strided(const ExecSpace& exec, int ni, int nk,
+                                            const double* a, const double* b, const double* c, double* y,
+                                            long stride_i, long stride_k,
+                                            const tuning::LaunchParams& launch = {}) {
+  const Kokkos::LayoutStride layout(ni, stride_i, nk, stride_k);
+  solve_tridiagonal_columns(exec, ni, nk, AllColumns{}, StridedConstMatrix(a, layout), StridedConstMatrix(b, layout),
+                            StridedConstMatrix(c, layout), StridedMatrix(y, layout), launch);
+}
+
+// Splits columns [0, ni) into one contiguous group per instance (e.g. from
+// Kokkos::Experimental::partition_space), solves every group on its own
+// instance and waits on the instance fences only.  Small batches then run
+// side by side instead of each filling the whole machine in turn.
+template <class Accum = void, class AView, class BView, class CView, class RhsView>
+void solve_tridiagonal_kokkos_partitioned(const std::vector<ExecSpace>& instances, int ni, int nk,
+                                          AView a, BView b, CView c, RhsView y,
+                                          const tuning::LaunchParams& launch = {}) {
+  const int groups = int(instances.size());
+  auto launch_group = [&](int g) {
+    const int begin = int(long(ni) * g / groups);
+    const int end = int(long(ni) * (g + 1) / groups);
+    // A team size tuned on the whole space may not fit one partition
+    tuning::LaunchParams group_launch = launch;
+    group_launch.team_size = std::min(group_launch.team_size, instances[g].concurrency());
+    solve_tridiagonal_columns<Accum>(instances[g], end - begin, nk, ColumnRange{begin}, a, b, c, y, group_launch);
+  };
+  
+#ifdef KOKKOS_ENABLE_OPENMP
+  if constexpr (std::is_same_v<ExecSpace, Kokkos::OpenMP>) {
+    // An OpenMP launch runs on the calling thread until it completes, so each
+    // partition needs its own dispatching thread to run concurrently
+    std::vector<std::thread> workers;
+    for (int g = 1; g < groups; g++) {
+      workers.emplace_back([&, g] {
+        launch_group(g);
+        instances[g].fence("thomas_partition");
+      });
+    }
+    if (groups > 0) {
+      launch_group(0);
+      instances[0].fence("thomas_partition");
+    }
+    for (auto& w : workers) w.join();
+    return;
+  }
+#endif
+  
+  // Device backends launch asynchronously: enqueue every group, then wait
+  for (int g = 0; g < groups; g++) launch_group(g);
+  for (int g = 0; g < groups; g++) instances[g].fence("thomas_partition");
+}
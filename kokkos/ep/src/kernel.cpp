@@ -1,61 +1,598 @@
 #include <Kokkos_Core.hpp>
+#include <Kokkos_SIMD.hpp>
 #include <iostream>
 #include <cmath>
 #include <chrono>
 #include <iomanip>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-int main(int argc, char* argv[]) {
-  if (argc < 3) {
-    std::cerr << "Usage: kernel <n> <reps>" << std::endl;
-    return 1;
+// SIMD type for the vectorised path: the widest native type on the host,
+// one lane on GPU backends where each thread is already a lane
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP) || defined(KOKKOS_ENABLE_SYCL)
+using simd_double = Kokkos::Experimental::simd<double, Kokkos::Experimental::simd_abi::scalar>;
+#else
+using simd_double = Kokkos::Experimental::native_simd<double>;
+#endif
+
+// Polynomial exp/cos written only in terms of +, - and *, so the same code
+// evaluates one double or a whole simd_double without calling libm.  Both
+// reduce the argument with lane-uniform operations (no per-lane branches).
+// For the O(1) arguments EP produces both are within a few ulps; exp keeps
+// ~1e-13 relative accuracy for x >= 0 (1e-16 absolute for x < 0) over its
+// whole range, and cos stays below 1e-13 absolute for |x| up to ~1e3.
+
+// exp(x) = exp(x / 2^11)^(2^11): |x / 2^11| < 0.35 for every finite result,
+// where a degree-12 Taylor polynomial is exact to double precision.  The
+// squarings run on q = exp(r) - 1, (1 + q)^2 = 1 + q * (2 + q), so rounding
+// is not amplified 2^11 times while the result is still O(1).
+template <class T>
+KOKKOS_INLINE_FUNCTION T poly_exp(const T& x) {
+  const T r = x * T(1.0 / 2048.0);
+  T q = T(2.08767569878680989792e-09);  // 1/12!
+  q = q * r + T(2.50521083854417187751e-08);
+  q = q * r + T(2.75573192239858906526e-07);
+  q = q * r + T(2.75573192239858906526e-06);
+  q = q * r + T(2.48015873015873015873e-05);
+  q = q * r + T(1.98412698412698412698e-04);
+  q = q * r + T(1.38888888888888888889e-03);
+  q = q * r + T(8.33333333333333333333e-03);
+  q = q * r + T(4.16666666666666666667e-02);
+  q = q * r + T(1.66666666666666666667e-01);
+  q = q * r + T(0.5);
+  q = q * r + T(1.0);
+  q = q * r;
+  for (int s = 0; s < 11; ++s) q = q * (T(2.0) + q);
+  return q + T(1.0);
+}
+
+// cos(x): reduce to r in [-pi, pi] with a two-part 2*pi (round-to-nearest via
+// the 1.5*2^52 trick), evaluate cos(r/4) by Taylor series, then apply the
+// double-angle formula twice
+template <class T>
+KOKKOS_INLINE_FUNCTION T poly_cos(const T& x) {
+  const double round_magic = 6755399441055744.0;  // 1.5 * 2^52
+  const double inv_two_pi = 1.59154943091895335769e-01;
+  const double two_pi_hi = 6.28318530717958623200e+00;
+  const double two_pi_lo = 2.44929359829470635445e-16;
+  const T q = (x * T(inv_two_pi) + T(round_magic)) - T(round_magic);
+  const T r = (x - q * T(two_pi_hi)) - q * T(two_pi_lo);
+  const T s = r * T(0.25);
+  const T s2 = s * s;
+  T c = T(4.77947733238738529744e-14);  // 1/16!
+  c = c * s2 - T(1.14707455977297247139e-11);
+  c = c * s2 + T(2.08767569878680989792e-09);
+  c = c * s2 - T(2.75573192239858906526e-07);
+  c = c * s2 + T(2.48015873015873015873e-05);
+  c = c * s2 - T(1.38888888888888888889e-03);
+  c = c * s2 + T(4.16666666666666666667e-02);
+  c = c * s2 - T(0.5);
+  c = c * s2 + T(1.0);
+  c = T(2.0) * c * c - T(1.0);
+  c = T(2.0) * c * c - T(1.0);
+  return c;
+}
+
+// Range-aware fused evaluation: on a known input interval [lo, hi],
+// exp(x) * cos(x) is one smooth function and needs no range reduction at all.
+// It is interpolated at Chebyshev nodes (within a small factor of the minimax
+// polynomial) and evaluated by Horner's rule in t = (2x - lo - hi) / (hi - lo).
+// The degree is raised until the fit meets the error bound on a dense grid
+// checked against libm; if it cannot, the caller falls back to libm.
+constexpr int range_poly_max_terms = 24;
+
+struct RangePoly {
+  Kokkos::Array<double, range_poly_max_terms> coef;  // monomial coefficients in t
+  int terms = 0;                                     // 0 when no fit met the bound
+  double scale = 1.0;
+  double shift = 0.0;
+  double max_error = 0.0;
+  double lo = 0.0, hi = 0.0;                         // interval the fit is valid on
+};
+
+RangePoly fit_range_poly(double lo, double hi, double bound) {
+  const double pi = 3.141592653589793;
+  if (hi - lo < 1e-12) {
+    const double pad = 1e-6 * (1.0 + std::abs(lo));
+    lo -= pad;
+    hi += pad;
   }
 
-  int n = std::atoi(argv[1]);
-  int reps = std::atoi(argv[2]);
+  RangePoly fit;
+  fit.lo = lo;
+  fit.hi = hi;
+  fit.scale = 2.0 / (hi - lo);
+  fit.shift = -(hi + lo) / (hi - lo);
+  auto f = [](double x) { return std::exp(x) * std::cos(x); };
 
-  Kokkos::initialize(argc, argv);
-  {
-    // Allocate arrays using Kokkos::View
-    Kokkos::View<double*> x("x", n);
-    Kokkos::View<double*> y("y", n);
+  for (int terms = 2; terms <= range_poly_max_terms; terms++) {
+    // Chebyshev coefficients from the values at the Chebyshev nodes
+    double cheb[range_poly_max_terms] = {};
+    for (int j = 0; j < terms; j++) {
+      double sum = 0.0;
+      for (int k = 0; k < terms; k++) {
+        const double theta = pi * (k + 0.5) / terms;
+        sum += f(0.5 * (hi - lo) * std::cos(theta) + 0.5 * (hi + lo)) * std::cos(j * theta);
+      }
+      cheb[j] = (j == 0 ? 1.0 : 2.0) * sum / terms;
+    }
+
+    // Convert sum_j cheb[j] T_j(t) to monomials with T_{j+1} = 2t T_j - T_{j-1}
+    double t_prev[range_poly_max_terms] = {1.0};
+    double t_curr[range_poly_max_terms] = {0.0, 1.0};
+    double mono[range_poly_max_terms] = {};
+    mono[0] = cheb[0];
+    if (terms > 1) mono[1] = cheb[1];
+    for (int j = 2; j < terms; j++) {
+      double t_next[range_poly_max_terms] = {};
+      for (int d = 0; d < j; d++) {
+        t_next[d + 1] += 2.0 * t_curr[d];
+        t_next[d] -= t_prev[d];
+      }
+      for (int d = 0; d <= j; d++) {
+        mono[d] += cheb[j] * t_next[d];
+        t_prev[d] = t_curr[d];
+        t_curr[d] = t_next[d];
+      }
+    }
+
+    // Check the Horner form that the kernel will actually evaluate
+    double err = 0.0;
+    const int samples = 4096;
+    for (int s = 0; s <= samples; s++) {
+      const double x = lo + (hi - lo) * s / samples;
+      const double t = x * fit.scale + fit.shift;
+      double p = mono[terms - 1];
+      for (int d = terms - 2; d >= 0; d--) p = p * t + mono[d];
+      err = std::max(err, std::abs(p - f(x)));
+    }
+    if (err <= bound) {
+      for (int d = 0; d < terms; d++) fit.coef[d] = mono[d];
+      fit.terms = terms;
+      fit.max_error = err;
+      return fit;
+    }
+  }
+  return fit;
+}
+
+// Host-side staging buffers for results.  Pinned memory lets the
+// device-to-host copies run asynchronously on an execution space instance.
+#ifdef KOKKOS_HAS_SHARED_HOST_PINNED_SPACE
+using StagingSpace = Kokkos::SharedHostPinnedSpace;
+#else
+using StagingSpace = Kokkos::HostSpace;
+#endif
+using StagingView = Kokkos::View<double*, StagingSpace>;
+
+// Writes y as one CSV line without touching device memory from the host.
+// Chunks are copied into two alternating staging buffers: while chunk c is
+// being formatted, the copy of chunk c+1 is already in flight, so a device
+// backend never stalls on one giant deep_copy before output starts.
+void write_csv_streamed(const Kokkos::View<double*>& y, std::ostream& os, int chunk) {
+  const int n = y.extent_int(0);
+  if (n == 0) {
+    os << std::endl;
+    return;
+  }
+  chunk = std::min(chunk, n);
+  const int nchunks = (n + chunk - 1) / chunk;
+  Kokkos::DefaultExecutionSpace exec;
+  StagingView staging[2] = {StagingView(Kokkos::view_alloc(Kokkos::WithoutInitializing, "staging_0"), chunk),
+                            StagingView(Kokkos::view_alloc(Kokkos::WithoutInitializing, "staging_1"), chunk)};
 
-    // Initialize arrays
-    Kokkos::parallel_for("init", n, KOKKOS_LAMBDA(const int i) {
-      x(i) = std::sin(3.14159 * static_cast<double>(i + 1) / static_cast<double>(n));
+  auto start_copy = [&](int c) {
+    const int begin = c * chunk;
+    const int end = std::min(n, begin + chunk);
+    Kokkos::deep_copy(exec, Kokkos::subview(staging[c % 2], Kokkos::make_pair(0, end - begin)),
+                      Kokkos::subview(y, Kokkos::make_pair(begin, end)));
+  };
+
+  start_copy(0);
+  for (int c = 0; c < nchunks; ++c) {
+    exec.fence("ep_output_chunk");
+    if (c + 1 < nchunks) start_copy(c + 1);
+
+    const StagingView& h = staging[c % 2];
+    const int begin = c * chunk;
+    const int end = std::min(n, begin + chunk);
+    for (int i = begin; i < end; ++i) {
+      os << std::fixed << std::setprecision(10) << h(i - begin);
+      os << (i < n - 1 ? "," : "\n");
+    }
+  }
+  os << std::flush;
+}
+
+// Applies the selected EP transform y(i) = f(x(i)) for i < len on `exec`.
+// Asynchronous: callers fence the instance when they need the result.
+void ep_compute(const Kokkos::DefaultExecutionSpace& exec, const std::string& impl, const RangePoly& fit,
+                Kokkos::View<const double*> x, Kokkos::View<double*> y, int len) {
+  using policy_t = Kokkos::RangePolicy<Kokkos::DefaultExecutionSpace>;
+  if (impl == "simd") {
+    // Whole vectors over the bulk of the array, the same polynomials on
+    // scalars for the remainder
+    constexpr int simd_width = int(simd_double::size());
+    const int nvec = len / simd_width;
+    Kokkos::parallel_for("ep_compute_simd", policy_t(exec, 0, nvec), KOKKOS_LAMBDA(const int v) {
+      simd_double xv;
+      xv.copy_from(x.data() + v * simd_width, Kokkos::Experimental::simd_flag_default);
+      simd_double yv = poly_exp(xv) * poly_cos(xv) + xv * xv;
+      yv.copy_to(y.data() + v * simd_width, Kokkos::Experimental::simd_flag_default);
+    });
+    Kokkos::parallel_for("ep_compute_simd_tail", policy_t(exec, nvec * simd_width, len),
+                         KOKKOS_LAMBDA(const int i) {
+      const double xi = x(i);
+      y(i) = poly_exp(xi) * poly_cos(xi) + xi * xi;
     });
+  } else if (impl == "range") {
+    Kokkos::parallel_for("ep_compute_range", policy_t(exec, 0, len), KOKKOS_LAMBDA(const int i) {
+      const double xi = x(i);
+      const double t = xi * fit.scale + fit.shift;
+      double p = fit.coef[fit.terms - 1];
+      for (int d = fit.terms - 2; d >= 0; d--) {
+        p = p * t + fit.coef[d];
+      }
+      y(i) = p + xi * xi;
+    });
+  } else {
+    // Embarrassingly parallel operations
+    Kokkos::parallel_for("ep_compute", policy_t(exec, 0, len), KOKKOS_LAMBDA(const int i) {
+      y(i) = std::exp(x(i)) * std::cos(x(i)) + x(i) * x(i);
+    });
+  }
+}
 
-    // Ensure all initialization is complete before timing
-    Kokkos::fence();
+// Parses a --range argument "<lo>:<hi>" with lo < hi.
+bool parse_range(const std::string& range, double& lo, double& hi) {
+  const auto colon = range.find(':');
+  if (colon == std::string::npos || colon == 0 || colon + 1 == range.size()) return false;
+  const std::string lo_text = range.substr(0, colon);
+  const std::string hi_text = range.substr(colon + 1);
+  char* end = nullptr;
+  lo = std::strtod(lo_text.c_str(), &end);
+  if (*end != '\0') return false;
+  hi = std::strtod(hi_text.c_str(), &end);
+  if (*end != '\0') return false;
+  return std::isfinite(lo) && std::isfinite(hi) && lo < hi;
+}
 
-    auto start_time = std::chrono::high_resolution_clock::now();
+// Fits the range polynomial and reports it; returns false when no degree
+// meets the bound and the caller should use libm instead.
+bool fit_and_report(double lo, double hi, RangePoly& fit) {
+  // 1e-14 is a few ulps of the O(1) results and far inside the 1e-10
+  // validation tolerance
+  fit = fit_range_poly(lo, hi, 1e-14);
+  if (fit.terms == 0) {
+    std::cerr << "No polynomial meets the error bound on [" << lo << ", " << hi
+              << "]; using libm" << std::endl;
+    return false;
+  }
+  std::cerr << "Range [" << lo << ", " << hi << "]: degree " << fit.terms - 1
+            << ", max error " << std::scientific << std::setprecision(2) << fit.max_error
+            << std::defaultfloat << std::endl;
+  return true;
+}
 
-    for (int rep = 0; rep < reps; ++rep) {
-      // Embarrassingly parallel operations
-      Kokkos::parallel_for("ep_compute", n, KOKKOS_LAMBDA(const int i) {
-        y(i) = std::exp(x(i)) * std::cos(x(i)) + x(i) * x(i);
-      });
+// Source of EP input for streaming mode: either the analytic initial
+// condition generated on the host, or raw native-endian doubles from a file
+// mapped read-only, so only the pages of the current chunk are resident.
+class StreamInput {
+ public:
+  StreamInput(std::int64_t n, const std::string& path) : m_n(n) {
+    if (path.empty()) return;
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+      if (fd >= 0) close(fd);
+      m_error = "cannot open input file " + path;
+      return;
+    }
+    if (size_t(st.st_size) < size_t(n) * sizeof(double)) {
+      close(fd);
+      m_error = "input file " + path + " holds fewer than n doubles";
+      return;
+    }
+    m_bytes = size_t(st.st_size);
+    void* p = mmap(nullptr, m_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+      m_error = "cannot map input file " + path;
+      return;
     }
+    madvise(p, m_bytes, MADV_SEQUENTIAL);
+    m_mapped = static_cast<const double*>(p);
+  }
+  ~StreamInput() {
+    if (m_mapped) munmap(const_cast<double*>(m_mapped), m_bytes);
+  }
+  StreamInput(const StreamInput&) = delete;
+  StreamInput& operator=(const StreamInput&) = delete;
 
-    Kokkos::fence();
-    auto end_time = std::chrono::high_resolution_clock::now();
+  // Empty unless the input file could not be used
+  const std::string& error() const { return m_error; }
+
+  // Fills out(0..len) with elements [begin, begin + len) and returns their
+  // range in min_val / max_val
+  void fill(const StagingView& out, std::int64_t begin, int len, double& min_val, double& max_val) const {
+    if (m_mapped) {
+      std::memcpy(out.data(), m_mapped + begin, size_t(len) * sizeof(double));
+    } else {
+      for (int j = 0; j < len; ++j) {
+        out(j) = std::sin(3.14159 * static_cast<double>(begin + j + 1) / static_cast<double>(m_n));
+      }
+    }
+    min_val = std::numeric_limits<double>::max();
+    max_val = std::numeric_limits<double>::lowest();
+    for (int j = 0; j < len; ++j) {
+      min_val = out(j) < min_val ? out(j) : min_val;
+      max_val = out(j) > max_val ? out(j) : max_val;
+    }
+  }
+
+ private:
+  std::int64_t m_n;
+  const double* m_mapped = nullptr;
+  size_t m_bytes = 0;
+  std::string m_error;
+};
 
-    // Output results in CSV format
-    for (int i = 0; i < n; ++i) {
-      if (i < n - 1) {
-        std::cout << std::fixed << std::setprecision(10) << y(i) << ",";
-      } else {
-        std::cout << std::fixed << std::setprecision(10) << y(i) << std::endl;
+// Streaming mode: the input passes through in fixed-size chunks using two
+// device buffer pairs and two host staging pairs, so the footprint is bounded
+// by the chunk size instead of n.  While the device works on chunk c (copy in,
+// transform, copy out on one instance), the host generates or reads chunk c+1
+// and consumes the results of chunk c-1.  Results are either written as CSV or
+// folded into a checksum.  With --impl range, chunks that leave the fitted
+// interval go to libm; their number is returned in libm_chunks.  Returns the
+// wall time of the pass.
+double run_streaming(const StreamInput& input, std::int64_t n, int chunk, const std::string& impl,
+                     const RangePoly& fit, bool write_csv, double& checksum, std::int64_t& libm_chunks) {
+  Kokkos::DefaultExecutionSpace exec;
+  const std::int64_t nchunks = (n + chunk - 1) / chunk;
+  Kokkos::View<double*> d_x[2] = {Kokkos::View<double*>("stream_x_0", chunk), Kokkos::View<double*>("stream_x_1", chunk)};
+  Kokkos::View<double*> d_y[2] = {Kokkos::View<double*>("stream_y_0", chunk), Kokkos::View<double*>("stream_y_1", chunk)};
+  StagingView h_x[2] = {StagingView(Kokkos::view_alloc(Kokkos::WithoutInitializing, "stream_hx_0"), chunk),
+                        StagingView(Kokkos::view_alloc(Kokkos::WithoutInitializing, "stream_hx_1"), chunk)};
+  StagingView h_y[2] = {StagingView(Kokkos::view_alloc(Kokkos::WithoutInitializing, "stream_hy_0"), chunk),
+                        StagingView(Kokkos::view_alloc(Kokkos::WithoutInitializing, "stream_hy_1"), chunk)};
+
+  const std::string libm = "baseline";
+  bool in_range[2] = {true, true};
+  auto chunk_len = [&](std::int64_t c) { return int(std::min<std::int64_t>(chunk, n - c * chunk)); };
+  auto stage = [&](std::int64_t c) {
+    const int b = int(c % 2);
+    double min_val = 0.0, max_val = 0.0;
+    input.fill(h_x[b], c * chunk, chunk_len(c), min_val, max_val);
+    // Outside its interval the polynomial extrapolates
+    in_range[b] = min_val >= fit.lo && max_val <= fit.hi;
+    if (impl == "range" && !in_range[b]) libm_chunks++;
+  };
+  auto launch = [&](std::int64_t c) {
+    const int b = int(c % 2);
+    const int len = chunk_len(c);
+    const auto part = Kokkos::make_pair(0, len);
+    Kokkos::deep_copy(exec, Kokkos::subview(d_x[b], part), Kokkos::subview(h_x[b], part));
+    ep_compute(exec, impl == "range" && !in_range[b] ? libm : impl, fit, d_x[b], d_y[b], len);
+    Kokkos::deep_copy(exec, Kokkos::subview(h_y[b], part), Kokkos::subview(d_y[b], part));
+  };
+  auto consume = [&](std::int64_t c) {
+    const StagingView& h = h_y[c % 2];
+    const int len = chunk_len(c);
+    const std::int64_t begin = c * chunk;
+    if (write_csv) {
+      for (int j = 0; j < len; ++j) {
+        std::cout << std::fixed << std::setprecision(10) << h(j);
+        std::cout << (begin + j < n - 1 ? "," : "\n");
       }
+    } else {
+      for (int j = 0; j < len; ++j) checksum += h(j);
     }
+  };
 
-    // Calculate and output timing
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time);
-    double time_per_iter = duration.count() / 1e9 / reps;
-    
-    std::cerr << "Time per iteration: " << std::fixed << std::setprecision(4) 
-              << time_per_iter << " seconds" << std::endl;
+  checksum = 0.0;
+  libm_chunks = 0;
+  auto start_time = std::chrono::high_resolution_clock::now();
+  stage(0);
+  launch(0);
+  for (std::int64_t c = 1; c < nchunks; ++c) {
+    // h_x[c % 2] was last read by chunk c-2, which completed before chunk c-1
+    // was launched
+    stage(c);
+    exec.fence("ep_stream_chunk");
+    launch(c);
+    consume(c - 1);
+  }
+  exec.fence("ep_stream_chunk");
+  consume(nchunks - 1);
+  if (write_csv) std::cout << std::flush;
+  auto end_time = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end_time - start_time).count();
+}
+
+// Streaming mode driver: timed passes fold the results into a checksum; with
+// CSV output the results are written by one extra, untimed pass.
+int run_stream_mode(std::int64_t n_total, int reps, int stream_chunk, std::string impl,
+                    const std::string& range, const std::string& input_path, const std::string& output) {
+  RangePoly fit;
+  if (impl == "range") {
+    double lo = 0.0, hi = 0.0;
+    parse_range(range, lo, hi);  // validated in main
+    if (!fit_and_report(lo, hi, fit)) {
+      impl = "baseline";
+    }
+  }
+
+  StreamInput input(n_total, input_path);
+  if (!input.error().empty()) {
+    std::cerr << "Error: " << input.error() << std::endl;
+    return 1;
+  }
+  const int chunk = int(std::min<std::int64_t>(stream_chunk, std::max<std::int64_t>(n_total, 1)));
+  double checksum = 0.0;
+  double total_time = 0.0;
+  std::int64_t libm_chunks = 0;
+  for (int rep = 0; rep < reps; ++rep) {
+    total_time += run_streaming(input, n_total, chunk, impl, fit, false, checksum, libm_chunks);
+  }
+  if (output == "csv") {
+    run_streaming(input, n_total, chunk, impl, fit, true, checksum, libm_chunks);
+  } else {
+    std::cout << std::scientific << std::setprecision(16) << checksum << std::endl;
+  }
+  if (libm_chunks > 0) {
+    std::cerr << libm_chunks << " of " << (n_total + chunk - 1) / chunk << " chunks exceed --range [" << fit.lo
+              << ", " << fit.hi << "]; those used libm" << std::endl;
+  }
+
+  double time_per_iter = total_time / reps;
+  std::cerr << "Time per iteration: " << std::fixed << std::setprecision(4)
+            << time_per_iter << " seconds" << std::endl;
+  std::cerr << "Streaming throughput: " << std::scientific << std::setprecision(3)
+            << double(n_total) / time_per_iter << " elements/s (chunk " << chunk << ")"
+            << std::defaultfloat << std::endl;
+  return 0;
+}
+
+// In-memory driver: x and y live in single Views of n elements.
+int run_in_memory_mode(int n, int reps, std::string impl, const std::string& range, const std::string& output) {
+  // Allocate arrays using Kokkos::View
+  Kokkos::View<double*> x("x", n);
+  Kokkos::View<double*> y("y", n);
+
+  // Initialize arrays
+  Kokkos::parallel_for("init", n, KOKKOS_LAMBDA(const int i) {
+    x(i) = std::sin(3.14159 * static_cast<double>(i + 1) / static_cast<double>(n));
+  });
+
+  // Ensure all initialization is complete before timing
+  Kokkos::fence();
+
+  // Fit the fused polynomial for the input interval
+  RangePoly fit;
+  if (impl == "range") {
+    Kokkos::MinMaxScalar<double> minmax;
+    Kokkos::parallel_reduce("ep_input_range", n, KOKKOS_LAMBDA(const int i, Kokkos::MinMaxScalar<double>& mm) {
+      mm.min_val = x(i) < mm.min_val ? x(i) : mm.min_val;
+      mm.max_val = x(i) > mm.max_val ? x(i) : mm.max_val;
+    }, Kokkos::MinMax<double>(minmax));
+    double lo = minmax.min_val, hi = minmax.max_val;
+    if (range != "auto") {
+      parse_range(range, lo, hi);  // validated in main
+    }
+    // Outside its interval the polynomial extrapolates, so inputs beyond a
+    // user range go to libm
+    if (minmax.min_val < lo || minmax.max_val > hi) {
+      std::cerr << "Input [" << minmax.min_val << ", " << minmax.max_val << "] exceeds --range [" << lo << ", "
+                << hi << "]; using libm" << std::endl;
+      impl = "baseline";
+    } else if (!fit_and_report(lo, hi, fit)) {
+      impl = "baseline";
+    }
+  }
+
+  // Each rep is fenced so its time covers the kernel itself, not just the
+  // launch; the mean and the best rep are reported
+  Kokkos::DefaultExecutionSpace exec;
+  double total_time = 0.0;
+  double best_time = 0.0;
+  for (int rep = 0; rep < reps; ++rep) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+    ep_compute(exec, impl, fit, x, y, n);
+    exec.fence("ep_rep");
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double rep_time = std::chrono::duration<double>(end_time - start_time).count();
+    total_time += rep_time;
+    best_time = (rep == 0 || rep_time < best_time) ? rep_time : best_time;
+  }
+
+  // Output results in CSV format
+  if (output == "csv") {
+    write_csv_streamed(y, std::cout, 1 << 16);
+  } else {
+    double checksum = 0.0;
+    Kokkos::parallel_reduce("ep_checksum", n, KOKKOS_LAMBDA(const int i, double& sum) {
+      sum += y(i);
+    }, checksum);
+    std::cout << std::scientific << std::setprecision(16) << checksum << std::endl;
   }
-  Kokkos::finalize();
 
+  // Calculate and output timing
+  double time_per_iter = total_time / reps;
+  
+  std::cerr << "Time per iteration: " << std::fixed << std::setprecision(4) 
+            << time_per_iter << " seconds" << std::endl;
+  std::cerr << "Best iteration: " << std::fixed << std::setprecision(6)
+            << best_time << " seconds" << std::endl;
   return 0;
 }
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: kernel <n> <reps> [--impl baseline|simd|range] [--range <lo>:<hi>]" << std::endl;
+    std::cerr << "              [--stream <chunk>] [--input <file>] [--output csv|checksum]" << std::endl;
+    return 1;
+  }
+
+  std::int64_t n_total = std::atoll(argv[1]);
+  int reps = std::atoi(argv[2]);
+  std::string impl = "baseline";
+  std::string range = "auto";  // input interval for --impl range, detected when "auto"
+  int stream_chunk = 0;        // elements per chunk in streaming mode, 0 = in-memory
+  std::string input_path;      // raw doubles to stream instead of the generated input
+  std::string output = "csv";
+  for (int i = 3; i + 1 < argc; i++) {
+    if (std::string(argv[i]) == "--impl") {
+      impl = argv[i+1];
+    } else if (std::string(argv[i]) == "--range") {
+      range = argv[i+1];
+    } else if (std::string(argv[i]) == "--stream") {
+      stream_chunk = std::atoi(argv[i+1]);
+    } else if (std::string(argv[i]) == "--input") {
+      input_path = argv[i+1];
+    } else if (std::string(argv[i]) == "--output") {
+      output = argv[i+1];
+    }
+  }
+  if (impl != "baseline" && impl != "simd" && impl != "range") {
+    std::cerr << "Unknown --impl " << impl << " (expected baseline|simd|range)" << std::endl;
+    return 1;
+  }
+  if (output != "csv" && output != "checksum") {
+    std::cerr << "Unknown --output " << output << " (expected csv|checksum)" << std::endl;
+    return 1;
+  }
+  if (stream_chunk <= 0 && (n_total > std::numeric_limits<int>::max() || !input_path.empty())) {
+    std::cerr << "n beyond 2^31 and --input need streaming mode (--stream <chunk>)" << std::endl;
+    return 1;
+  }
+  double range_lo = 0.0, range_hi = 0.0;
+  if (range != "auto" && !parse_range(range, range_lo, range_hi)) {
+    std::cerr << "Invalid --range " << range << " (expected <lo>:<hi> with lo < hi)" << std::endl;
+    return 1;
+  }
+  if (stream_chunk > 0 && impl == "range" && range == "auto") {
+    std::cerr << "--impl range in streaming mode needs the input interval (--range <lo>:<hi>)" << std::endl;
+    return 1;
+  }
+
+  int status = 0;
+  Kokkos::initialize(argc, argv);
+  {
+    if (stream_chunk > 0) {
+      status = run_stream_mode(n_total, reps, stream_chunk, impl, range, input_path, output);
+    } else {
+      status = run_in_memory_mode(int(n_total), reps, impl, range, output);
+    }
+  }
+  Kokkos::finalize();
+
+  return status;
+}
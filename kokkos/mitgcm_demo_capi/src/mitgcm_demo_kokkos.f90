@@ -0,0 +1,99 @@
+program mitgcm_demo_kokkos
+  use thomas_kokkos
+  implicit none
+  
+  ! Command line parameters
+  integer :: n, reps
+  character(len=32) :: arg
+  
+  ! Problem size parameters
+  integer, parameter :: Nr = 50    ! vertical levels (typical MITgcm)
+  real*8, parameter :: pi = 3.141592653589793d0
+  
+  ! Arrays - simplified to 2D slices (i,k) for demo
+  real*8, allocatable :: a(:,:), b(:,:), c(:,:), y(:,:)
+  real*8, allocatable :: y_result(:,:)
+  
+  ! Timing and iteration variables
+  integer :: i, k, rep, ierr
+  ! Wall clock: cpu_time would sum over the threads of the Kokkos backend
+  integer*8 :: start_count, end_count, count_rate
+  
+  ! Parse command line
+  if (command_argument_count() < 2) then
+    write(*,*) 'Usage: mitgcm_demo_kokkos <n> <reps>'
+    stop 1
+  endif
+  
+  call get_command_argument(1, arg)
+  read(arg, *) n
+  call get_command_argument(2, arg) 
+  read(arg, *) reps
+  
+  ! Allocate arrays
+  allocate(a(n,Nr), b(n,Nr), c(n,Nr), y(n,Nr), y_result(n,Nr))
+  
+  ! Initialize test matrices - tridiagonal system for heat diffusion
+  do k = 1, Nr
+    do i = 1, n
+      ! Lower diagonal (except first row)
+      if (k > 1) then
+        a(i,k) = -0.5d0
+      else
+        a(i,k) = 0.0d0
+      endif
+      
+      ! Main diagonal - always positive definite
+      b(i,k) = 2.0d0 + 0.1d0 * sin(pi * real(i)/real(n))
+      
+      ! Upper diagonal (except last row)  
+      if (k < Nr) then
+        c(i,k) = -0.5d0
+      else
+        c(i,k) = 0.0d0
+      endif
+      
+      ! RHS - some test function
+      y(i,k) = sin(pi * real(i)/real(n)) * cos(pi * real(k)/real(Nr))
+    enddo
+  enddo
+  
+  ierr = thomas_kokkos_initialize()
+  if (ierr /= THOMAS_KOKKOS_SUCCESS) then
+    write(0,*) 'thomas_kokkos_initialize failed: ', ierr
+    stop 1
+  endif
+  
+  call system_clock(start_count, count_rate)
+  
+  do rep = 1, reps
+    ! Copy y to y_result for each iteration
+    y_result = y
+    
+    ! Call the Kokkos tridiagonal solver in place on the Fortran arrays
+    ierr = thomas_kokkos_solve(n, Nr, a, b, c, y_result)
+    if (ierr /= THOMAS_KOKKOS_SUCCESS) then
+      write(0,*) 'thomas_kokkos_solve failed: ', ierr
+      stop 1
+    endif
+  enddo
+  
+  call system_clock(end_count)
+  
+  ! Write output to CSV format
+  do i = 1, n
+    do k = 1, Nr
+      if (k < Nr) then
+        write(*,'(F16.10,A)', advance='no') y_result(i,k), ','
+      else
+        write(*,'(F16.10)') y_result(i,k)
+      endif
+    enddo
+  enddo
+  
+  ! Write timing info to stderr
+  write(0,'(A,F8.4,A)') 'Time per iteration: ', real(end_count - start_count, 8) / real(count_rate, 8) / reps, ' seconds'
+  
+  deallocate(a, b, c, y, y_result)
+  ierr = thomas_kokkos_finalize()
+end program
@@ -0,0 +1,64 @@
+#include <Kokkos_Core.hpp>
+#include <memory>
+
+#include "thomas_kokkos.h"
+#include "solver_context.hpp"
+
+// extern "C" wrapper around the optimized Thomas solver for Fortran and C host
+// models.  One ThomasSolverContext lives from thomas_kokkos_initialize to
+// thomas_kokkos_finalize, so the runtime and any device workspace stay warm
+// across calls.  Caller arrays are wrapped as unmanaged strided Views; on host
+// backends the solver runs on them in place with no allocation or copy.
+
+namespace {
+
+std::unique_ptr<ThomasSolverContext> g_context;
+
+void create_context() {
+  const bool app_runtime = Kokkos::is_initialized();
+  g_context = std::make_unique<ThomasSolverContext>();
+  // On the application's runtime the context's instance and Views must be
+  // released before that runtime goes down, not in static destruction after
+  // it, even if thomas_kokkos_finalize is never called
+  if (app_runtime) Kokkos::push_finalize_hook([] { g_context.reset(); });
+}
+
+// True when two different (i,k) elements share an address: the dimension
+// with the larger stride must step over the whole extent of the other one.
+bool strides_overlap(int ni, int nk, long stride_i, long stride_k) {
+  if (ni == 1 || nk == 1) return false;
+  if (stride_i >= stride_k) return stride_i < stride_k * nk;
+  return stride_k < stride_i * ni;
+}
+
+}  // namespace
+
+extern "C" int thomas_kokkos_initialize(void) {
+  if (!g_context) create_context();
+  return THOMAS_KOKKOS_SUCCESS;
+}
+
+extern "C" int thomas_kokkos_finalize(void) {
+  g_context.reset();  // finalizes Kokkos only if the context started it
+  return THOMAS_KOKKOS_SUCCESS;
+}
+
+extern "C" int thomas_kokkos_solve(int ni, int nk, const double* a, const double* b, const double* c, double* y) {
+  return thomas_kokkos_solve_strided(ni, nk, a, b, c, y, 1, ni);
+}
+
+extern "C" int thomas_kokkos_solve_strided(int ni, int nk, const double* a, const double* b, const double* c,
+                                           double* y, long stride_i, long stride_k) {
+  if (!g_context) {
+    // An application that runs Kokkos itself may skip thomas_kokkos_initialize
+    if (!Kokkos::is_initialized()) return THOMAS_KOKKOS_NOT_INITIALIZED;
+    create_context();
+  }
+  if (ni < 0 || nk < 1 || stride_i < 1 || stride_k < 1) return THOMAS_KOKKOS_INVALID_ARGUMENT;
+  if (ni == 0) return THOMAS_KOKKOS_SUCCESS;
+  if (strides_overlap(ni, nk, stride_i, stride_k)) return THOMAS_KOKKOS_INVALID_ARGUMENT;
+  if (a == nullptr || b == nullptr || c == nullptr || y == nullptr) return THOMAS_KOKKOS_INVALID_ARGUMENT;
+
+  g_context->solve_host(ni, nk, a, b, c, y, stride_i, stride_k);
+  return THOMAS_KOKKOS_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#ifndef THOMAS_KOKKOS_H
+#define THOMAS_KOKKOS_H
+/* C interface to the optimized Kokkos Thomas solver (kokkos/common/thomas_solver.hpp).
+ *
+ * Arrays hold ni columns of nk levels.  On host backends they are wrapped
+ * as unmanaged Kokkos Views and solved in place, with no allocation or copy.
+ * Every function returns THOMAS_KOKKOS_SUCCESS or an error code. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+  THOMAS_KOKKOS_SUCCESS = 0,
+  THOMAS_KOKKOS_NOT_INITIALIZED = 1,
+  THOMAS_KOKKOS_INVALID_ARGUMENT = 2
+};
+
+/* Creates the persistent solver context, initializing Kokkos unless the
+ * application already has; finalize releases it and only shuts down a
+ * runtime that initialize started.  Call both once per run, not per solve.
+ *
+ * An application that runs Kokkos itself may skip both: the first solve then
+ * creates the context on the application's runtime.  Such a context is
+ * released by a Kokkos finalize hook at the application's Kokkos::finalize
+ * at the latest; calling thomas_kokkos_finalize before that is still fine. */
+int thomas_kokkos_initialize(void);
+int thomas_kokkos_finalize(void);
+
+/* Solves the ni independent systems a(i,k) y(i,k-1) + b(i,k) y(i,k) +
+ * c(i,k) y(i,k+1) = y(i,k) in place; the solve has completed on return.
+ * Arrays are column-major (Fortran order): element (i,k) is at [i + ni*k]. */
+int thomas_kokkos_solve(int ni, int nk, const double* a, const double* b, const double* c, double* y);
+
+/* As thomas_kokkos_solve, with element (i,k) of every array at
+ * [i*stride_i + k*stride_k], e.g. (1, lda) for a padded Fortran array or
+ * (nk, 1) for a row-major C array.  Strides are in elements, must be >= 1
+ * and must not make two elements share an address (e.g. stride_i = stride_k
+ * with ni, nk > 1); such strides give THOMAS_KOKKOS_INVALID_ARGUMENT. */
+int thomas_kokkos_solve_strided(int ni, int nk, const double* a, const double* b, const double* c, double* y,
+                                long stride_i, long stride_k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+! Fortran bindings for the Kokkos Thomas solver (thomas_kokkos.h).
+!
+! Arrays are passed by address and wrapped on the C side as unmanaged Views,
+! so model arrays are solved in place with no copy.  thomas_kokkos_solve takes
+! contiguous (ni,nk) arrays; thomas_kokkos_solve_strided takes the element
+! strides between columns and between levels, e.g. (1, size(a,1)) to solve
+! rows i0..i0+ni-1 of a larger or padded array.
+!
+! For the strided call pass the first element of the parent array, e.g.
+!   ierr = thomas_kokkos_solve_strided(ni, nk, a(i0,1), b(i0,1), c(i0,1), y(i0,1), 1_c_long, int(size(a,1), c_long))
+! and never an array section such as a(i0:i0+ni-1,:): the dummies are
+! assumed-size, so a non-contiguous section is copied into a contiguous
+! temporary and the parent-array strides then address memory outside it.
+module thomas_kokkos
+  use iso_c_binding, only: c_int, c_long, c_double
+  implicit none
+  private
+  public :: thomas_kokkos_initialize, thomas_kokkos_finalize, thomas_kokkos_solve, thomas_kokkos_solve_strided
+  public :: THOMAS_KOKKOS_SUCCESS, THOMAS_KOKKOS_NOT_INITIALIZED, THOMAS_KOKKOS_INVALID_ARGUMENT
+
+  integer(c_int), parameter :: THOMAS_KOKKOS_SUCCESS = 0
+  integer(c_int), parameter :: THOMAS_KOKKOS_NOT_INITIALIZED = 1
+  integer(c_int), parameter :: THOMAS_KOKKOS_INVALID_ARGUMENT = 2
+
+  interface
+    integer(c_int) function thomas_kokkos_initialize() bind(C, name='thomas_kokkos_initialize')
+      import :: c_int
+    end function
+
+    integer(c_int) function thomas_kokkos_finalize() bind(C, name='thomas_kokkos_finalize')
+      import :: c_int
+    end function
+
+    integer(c_int) function thomas_kokkos_solve(ni, nk, a, b, c, y) bind(C, name='thomas_kokkos_solve')
+      import :: c_int, c_double
+      integer(c_int), value :: ni, nk
+      real(c_double), intent(in) :: a(ni,nk), b(ni,nk), c(ni,nk)
+      real(c_double), intent(inout) :: y(ni,nk)
+    end function
+
+    integer(c_int) function thomas_kokkos_solve_strided(ni, nk, a, b, c, y, stride_i, stride_k) &
+        bind(C, name='thomas_kokkos_solve_strided')
+      import :: c_int, c_long, c_double
+      integer(c_int), value :: ni, nk
+      real(c_double), intent(in) :: a(*), b(*), c(*)
+      real(c_double), intent(inout) :: y(*)
+      integer(c_long), value :: stride_i, stride_k
+    end function
+  end interface
+end module thomas_kokkos
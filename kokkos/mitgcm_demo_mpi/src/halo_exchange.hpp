@@ -0,0 +1,222 @@
+#pragma once
+// Tile decomposition and overlap (halo) exchange for the MPI mitgcm driver.
+//
+// The global nx x ny grid of columns is split into px x py tiles, one per
+// rank, on a periodic Cartesian communicator.  Each tile stores its
+// sNx x sNy interior columns plus an overlap ring of width OL, flattened into
+// the column index of a (column, level) LayoutLeft View exactly like the
+// single-process kernels, so the Thomas solver runs on a tile unchanged.
+//
+// exch_xy / exch_xyz fill the same overlap as MITgcm's EXCH_XY_RL /
+// EXCH_XYZ_RL, but in a single round of messages to all eight neighbours
+// (edges and corners) rather than an x pass followed by a y pass, so the
+// exchange can be split into begin_xyz / end_xyz with independent work in
+// between.  Edges are packed into contiguous device buffers; unless the MPI
+// library is GPU-aware they are staged through host mirrors.
+
+#include <Kokkos_Core.hpp>
+#include <mpi.h>
+#include <string>
+
+using HaloLayout = Kokkos::LayoutLeft;
+using HaloMemSpace = Kokkos::DefaultExecutionSpace::memory_space;
+using HaloExecSpace = Kokkos::DefaultExecutionSpace;
+
+struct TileGeometry {
+  int sNx = 0, sNy = 0;  // interior columns
+  int OL = 0;            // overlap width
+
+  KOKKOS_INLINE_FUNCTION int nxt() const { return sNx + 2 * OL; }
+  KOKKOS_INLINE_FUNCTION int nyt() const { return sNy + 2 * OL; }
+  KOKKOS_INLINE_FUNCTION int ncols() const { return nxt() * nyt(); }
+
+  // Column index of local (i,j); interior is 0 <= i < sNx, 0 <= j < sNy and
+  // the overlap extends OL columns beyond on every side.
+  KOKKOS_INLINE_FUNCTION int col(int i, int j) const { return (i + OL) + nxt() * (j + OL); }
+};
+
+struct Decomposition {
+  MPI_Comm comm = MPI_COMM_NULL;  // periodic Cartesian communicator
+  int rank = 0, nranks = 1;
+  int px = 1, py = 1;             // process grid
+  int cx = 0, cy = 0;             // this rank's position in it
+  int nx = 0, ny = 0;             // global columns
+  int i0 = 0, j0 = 0;             // global index of local (0,0)
+  TileGeometry tile;
+};
+
+// px/py of 0 let MPI_Dims_create choose.  Returns false with `err` set when
+// the grid does not divide evenly or the tile is narrower than the overlap.
+inline bool make_decomposition(MPI_Comm world, int nx, int ny, int px, int py, int OL, Decomposition& d,
+                               std::string& err) {
+  int nranks = 0;
+  MPI_Comm_size(world, &nranks);
+  int dims[2] = {px, py};
+  // A fixed dimension must divide nranks before MPI_Dims_create sees it: it
+  // fails otherwise, and under MPI_ERRORS_ARE_FATAL that aborts the job
+  const bool fixed_fits = px >= 0 && py >= 0 && (px == 0 || nranks % px == 0) && (py == 0 || nranks % py == 0) &&
+                          (px == 0 || py == 0 || px * py == nranks);
+  if (!fixed_fits || MPI_Dims_create(nranks, 2, dims) != MPI_SUCCESS) {
+    err = "process grid " + std::to_string(px) + "x" + std::to_string(py) + " does not match " +
+          std::to_string(nranks) + " ranks";
+    return false;
+  }
+  if (nx % dims[0] != 0 || ny % dims[1] != 0) {
+    err = "grid " + std::to_string(nx) + "x" + std::to_string(ny) + " is not divisible by process grid " +
+          std::to_string(dims[0]) + "x" + std::to_string(dims[1]);
+    return false;
+  }
+  d.tile.sNx = nx / dims[0];
+  d.tile.sNy = ny / dims[1];
+  d.tile.OL = OL;
+  if (OL < 1 || d.tile.sNx < OL || d.tile.sNy < OL) {
+    err = "overlap " + std::to_string(OL) + " must be >= 1 and no wider than a tile (" + std::to_string(d.tile.sNx) +
+          "x" + std::to_string(d.tile.sNy) + ")";
+    return false;
+  }
+
+  int periods[2] = {1, 1};
+  MPI_Cart_create(world, 2, dims, periods, 0, &d.comm);
+  MPI_Comm_rank(d.comm, &d.rank);
+  d.nranks = nranks;
+  int coords[2];
+  MPI_Cart_coords(d.comm, d.rank, 2, coords);
+  d.px = dims[0];
+  d.py = dims[1];
+  d.cx = coords[0];
+  d.cy = coords[1];
+  d.nx = nx;
+  d.ny = ny;
+  d.i0 = d.cx * d.tile.sNx;
+  d.j0 = d.cy * d.tile.sNy;
+  return true;
+}
+
+class HaloExchange {
+ public:
+  using Field2D = Kokkos::View<double*, HaloLayout, HaloMemSpace>;
+  using Field3D = Kokkos::View<double**, HaloLayout, HaloMemSpace>;
+
+  // Buffers are sized for fields of up to `nk_max` levels.
+  HaloExchange(const Decomposition& d, int nk_max, bool gpu_aware_mpi)
+      : m_d(d), m_nk_max(nk_max), m_gpu_aware(gpu_aware_mpi) {
+    const TileGeometry& t = d.tile;
+    for (int n = 0; n < 8; n++) {
+      const int m = n + (n >= 4);  // 3x3 stencil position, skipping (0,0)
+      const int dx = m % 3 - 1;
+      const int dy = m / 3 - 1;
+      int coords[2] = {(d.cx + dx + d.px) % d.px, (d.cy + dy + d.py) % d.py};
+      MPI_Cart_rank(d.comm, coords, &m_neighbor[n]);
+
+      // Edge this rank sends towards (dx,dy), and the overlap filled from the
+      // neighbour in that direction; both have the same shape
+      m_edge[n] = {dx > 0 ? t.sNx - t.OL : 0, dx == 0 ? t.sNx : t.OL,
+                   dy > 0 ? t.sNy - t.OL : 0, dy == 0 ? t.sNy : t.OL};
+      m_halo[n] = {dx < 0 ? -t.OL : dx == 0 ? 0 : t.sNx, m_edge[n].ni,
+                   dy < 0 ? -t.OL : dy == 0 ? 0 : t.sNy, m_edge[n].nj};
+
+      const size_t len = size_t(m_edge[n].ni) * m_edge[n].nj * nk_max;
+      m_send[n] = Buffer(Kokkos::view_alloc(Kokkos::WithoutInitializing, "halo_send"), len);
+      m_recv[n] = Buffer(Kokkos::view_alloc(Kokkos::WithoutInitializing, "halo_recv"), len);
+      m_send_host[n] = Kokkos::create_mirror_view(m_send[n]);
+      m_recv_host[n] = Kokkos::create_mirror_view(m_recv[n]);
+    }
+  }
+
+  void exch_xy(Field2D f) {
+    exch_xyz(Field3D(f.data(), f.extent(0), 1));
+  }
+
+  void exch_xyz(Field3D f) {
+    HaloExecSpace exec;
+    begin_xyz(exec, f);
+    end_xyz(exec, f);
+  }
+
+  // Packs the edges of `f` on `exec` and posts all sends and receives.  Only
+  // the overlap of `f` may be written before the matching end_xyz; interior
+  // columns can be read and updated elsewhere in the meantime.
+  void begin_xyz(const HaloExecSpace& exec, Field3D f) {
+    const int nk = int(f.extent(1));
+    if (nk > m_nk_max) Kokkos::abort("HaloExchange: field has more levels than the exchange buffers");
+    const double start = MPI_Wtime();
+    m_nk = nk;
+    for (int n = 0; n < 8; n++) pack(exec, f, nk, m_edge[n], m_send[n]);
+    if (!m_gpu_aware) {
+      for (int n = 0; n < 8; n++) Kokkos::deep_copy(exec, m_send_host[n], m_send[n]);
+    }
+    exec.fence("HaloExchange::begin_xyz");
+
+    // Each message is tagged with its direction of travel, so exchanges with
+    // the same rank in several directions (periodic, one rank across) pair up.
+    for (int n = 0; n < 8; n++) {
+      const int count = m_edge[n].ni * m_edge[n].nj * nk;
+      MPI_Irecv(recv_ptr(n), count, MPI_DOUBLE, m_neighbor[n], 7 - n, m_d.comm, &m_req[n]);
+    }
+    for (int n = 0; n < 8; n++) {
+      const int count = m_edge[n].ni * m_edge[n].nj * nk;
+      MPI_Isend(send_ptr(n), count, MPI_DOUBLE, m_neighbor[n], n, m_d.comm, &m_req[8 + n]);
+    }
+    m_seconds += MPI_Wtime() - start;
+  }
+
+  // Waits for the messages posted by begin_xyz and unpacks them into the
+  // overlap of `f` on `exec`.  The unpack is ordered on `exec` but not fenced.
+  void end_xyz(const HaloExecSpace& exec, Field3D f) {
+    const double start = MPI_Wtime();
+    MPI_Waitall(16, m_req, MPI_STATUSES_IGNORE);
+    if (!m_gpu_aware) {
+      for (int n = 0; n < 8; n++) Kokkos::deep_copy(exec, m_recv[n], m_recv_host[n]);
+    }
+    for (int n = 0; n < 8; n++) unpack(exec, f, m_nk, m_halo[n], m_recv[n]);
+    exec.fence("HaloExchange::end_xyz");
+    m_seconds += MPI_Wtime() - start;
+  }
+
+  // Wall time spent inside exchanges so far (packing and waiting); with
+  // begin/end split this is the part not hidden behind other work.
+  double seconds() const { return m_seconds; }
+  void reset_timer() { m_seconds = 0.0; }
+
+ private:
+  using Buffer = Kokkos::View<double*, HaloMemSpace>;
+
+  // Rectangle of local columns [i0, i0+ni) x [j0, j0+nj).
+  struct Edge {
+    int i0, ni, j0, nj;
+  };
+
+  double* send_ptr(int n) { return m_gpu_aware ? m_send[n].data() : m_send_host[n].data(); }
+  double* recv_ptr(int n) { return m_gpu_aware ? m_recv[n].data() : m_recv_host[n].data(); }
+
+  void pack(const HaloExecSpace& exec, Field3D f, int nk, Edge e, Buffer buf) const {
+    const TileGeometry t = m_d.tile;
+    Kokkos::parallel_for("halo_pack",
+      Kokkos::MDRangePolicy<HaloExecSpace, Kokkos::Rank<3>>(exec, {0, 0, 0}, {e.ni, e.nj, nk}),
+      KOKKOS_LAMBDA(int ii, int jj, int k) {
+        buf(ii + e.ni * (jj + e.nj * k)) = f(t.col(e.i0 + ii, e.j0 + jj), k);
+      });
+  }
+
+  void unpack(const HaloExecSpace& exec, Field3D f, int nk, Edge e, Buffer buf) const {
+    const TileGeometry t = m_d.tile;
+    Kokkos::parallel_for("halo_unpack",
+      Kokkos::MDRangePolicy<HaloExecSpace, Kokkos::Rank<3>>(exec, {0, 0, 0}, {e.ni, e.nj, nk}),
+      KOKKOS_LAMBDA(int ii, int jj, int k) {
+        f(t.col(e.i0 + ii, e.j0 + jj), k) = buf(ii + e.ni * (jj + e.nj * k));
+      });
+  }
+
+  Decomposition m_d;
+  int m_nk_max;
+  bool m_gpu_aware;
+  int m_nk = 0;
+  double m_seconds = 0.0;
+  // Neighbours in the order (-1,-1) (0,-1) (1,-1) (-1,0) (1,0) (-1,1) (0,1)
+  // (1,1), so the opposite of direction n is 7-n.
+  int m_neighbor[8];
+  Edge m_edge[8], m_halo[8];
+  Buffer m_send[8], m_recv[8];
+  Buffer::HostMirror m_send_host[8], m_recv_host[8];
+  MPI_Request m_req[16];
+};
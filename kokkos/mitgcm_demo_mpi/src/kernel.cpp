@@ -0,0 +1,301 @@
+#include <Kokkos_Core.hpp>
+#include <mpi.h>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thomas_solver.hpp"
+#include "halo_exchange.hpp"
+
+using namespace Kokkos;
+
+// Rank-decomposed mitgcm demo: every rank owns one tile of an nx x ny grid of
+// columns (plus overlap), each time step exchanges the overlap, applies an
+// explicit horizontal smoothing and then the implicit vertical (tridiagonal)
+// solve on every column of the tile.  Output is the global field gathered on
+// rank 0, one CSV row of Nr values per column, ordered by j then i, so runs
+// on different rank counts can be compared directly.
+//
+// With --split the tile is divided into interior columns, whose smoothing
+// stencil only touches columns this rank owns, and boundary columns (the
+// outer interior ring plus the overlap).  The interior is smoothed and solved
+// on one execution space instance while the halo messages are in flight; the
+// boundary follows on a second instance once they have arrived.  An OpenMP
+// launch blocks its calling thread, so there the exchange and the boundary
+// work run on a separate host thread (the only one calling MPI during the
+// step), as in solve_tridiagonal_kokkos_partitioned.
+
+#ifdef KOKKOS_ENABLE_OPENMP
+constexpr bool threaded_split = std::is_same_v<ExecSpace, Kokkos::OpenMP>;
+#else
+constexpr bool threaded_split = false;
+#endif
+
+// Explicit horizontal smoothing of columns map(0..n-1) wherever all four
+// neighbours are held locally; the outermost overlap ring is carried through
+// unchanged.
+template <class ColumnMap>
+void horizontal_smooth(const ExecSpace& exec, int n, int nk, ColumnMap map, TileGeometry t, double nu,
+                       View<double**, Layout, MemSpace> y, View<double**, Layout, MemSpace> y_new) {
+  pushRegion("horizontal_smooth");
+  parallel_for("horizontal_smooth", MDRangePolicy<ExecSpace, Rank<2>>(exec, {0,0}, {n,nk}),
+               KOKKOS_LAMBDA(int idx, int k) {
+    const int m = map(idx);
+    const int ii = m % t.nxt();
+    const int jj = m / t.nxt();
+    if (ii == 0 || jj == 0 || ii == t.nxt()-1 || jj == t.nyt()-1) {
+      y_new(m,k) = y(m,k);
+    } else {
+      const int i = ii - t.OL;
+      const int j = jj - t.OL;
+      y_new(m,k) = y(m,k) + nu * (y(t.col(i-1,j),k) + y(t.col(i+1,j),k) + y(t.col(i,j-1),k) +
+                                  y(t.col(i,j+1),k) - 4.0 * y(m,k));
+    }
+  });
+  popRegion();
+}
+
+int main(int argc, char* argv[]) {
+  int thread_level = MPI_THREAD_SINGLE;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &thread_level);
+  int world_rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+  if (argc < 4) {
+    if (world_rank == 0) {
+      std::cerr << "Usage: " << argv[0] << " <nx> <ny> <steps>" << std::endl;
+      std::cerr << "  options: --px <P> --py <Q>  --overlap <OL>  --gpu-aware-mpi  --split" << std::endl;
+    }
+    MPI_Finalize();
+    return 1;
+  }
+
+  int nx = std::atoi(argv[1]);
+  int ny = std::atoi(argv[2]);
+  int steps = std::atoi(argv[3]);
+  int px = 0, py = 0;       // 0: let MPI_Dims_create choose
+  int overlap = 2;
+  bool gpu_aware_mpi = false;
+  bool split = false;       // overlap halo exchange with interior work
+  for (int i = 4; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--px" && i + 1 < argc) {
+      px = std::atoi(argv[++i]);
+    } else if (arg == "--py" && i + 1 < argc) {
+      py = std::atoi(argv[++i]);
+    } else if (arg == "--overlap" && i + 1 < argc) {
+      overlap = std::atoi(argv[++i]);
+    } else if (arg == "--gpu-aware-mpi") {
+      gpu_aware_mpi = true;
+    } else if (arg == "--split") {
+      split = true;
+    }
+  }
+
+  if (split && threaded_split && thread_level < MPI_THREAD_SERIALIZED) {
+    if (world_rank == 0) std::cerr << "Error: --split needs MPI_THREAD_SERIALIZED on this backend" << std::endl;
+    MPI_Finalize();
+    return 1;
+  }
+
+  Decomposition d;
+  std::string err;
+  if (!make_decomposition(MPI_COMM_WORLD, nx, ny, px, py, overlap, d, err)) {
+    if (world_rank == 0) std::cerr << "Error: " << err << std::endl;
+    MPI_Finalize();
+    return 1;
+  }
+
+  // Initialize Kokkos
+  initialize(argc, argv);
+  {
+    constexpr int Nr = 50;  // vertical levels (typical MITgcm)
+    constexpr double pi = 3.141592653589793;
+    constexpr double nu = 0.1;  // horizontal smoothing coefficient
+
+    const TileGeometry t = d.tile;
+    const int ncols = t.ncols();
+    const int gi0 = d.i0;
+    const int gj0 = d.j0;
+
+    if (d.rank == 0) {
+      std::cerr << "Decomposition: " << d.px << "x" << d.py << " ranks, tile " << t.sNx << "x" << t.sNy
+                << " + overlap " << t.OL << (gpu_aware_mpi ? " (GPU-aware MPI)" : "")
+                << (split ? ", split interior/boundary" : "") << std::endl;
+    }
+
+    View<double*, Layout, MemSpace> kappa("kappa", ncols);
+    View<double**, Layout, MemSpace> a("a", ncols, Nr);
+    View<double**, Layout, MemSpace> b("b", ncols, Nr);
+    View<double**, Layout, MemSpace> c("c", ncols, Nr);
+    View<double**, Layout, MemSpace> y("y", ncols, Nr);
+    View<double**, Layout, MemSpace> y_new("y_new", ncols, Nr);
+
+    HaloExchange halo(d, Nr, gpu_aware_mpi);
+
+    // Diffusivity is defined on the interior and the overlap is filled from
+    // the neighbours, as MITgcm does for its 2-D fields
+    pushRegion("initialization");
+    parallel_for("init_kappa", MDRangePolicy<Rank<2>>({0,0}, {t.sNx,t.sNy}),
+                 KOKKOS_LAMBDA(int i, int j) {
+      kappa(t.col(i,j)) = 0.1 * std::sin(pi * double(gi0+i+1)/double(nx)) * std::cos(pi * double(gj0+j+1)/double(ny));
+    });
+    halo.exch_xy(kappa);
+
+    parallel_for("init_matrices", MDRangePolicy<Rank<2>>({0,0}, {ncols,Nr}),
+                 KOKKOS_LAMBDA(int m, int k) {
+      // Lower diagonal (except first row)
+      a(m,k) = (k > 0) ? -0.5 : 0.0;
+      // Main diagonal - always positive definite
+      b(m,k) = 2.0 + kappa(m);
+      // Upper diagonal (except last row)
+      c(m,k) = (k < Nr-1) ? -0.5 : 0.0;
+    });
+
+    // Initial field on the interior; the first exchange fills the overlap
+    parallel_for("init_field", MDRangePolicy<Rank<3>>({0,0,0}, {t.sNx,t.sNy,Nr}),
+                 KOKKOS_LAMBDA(int i, int j, int k) {
+      y(t.col(i,j),k) = std::sin(pi * double(gi0+i+1)/double(nx)) * std::cos(pi * double(gj0+j+1)/double(ny)) *
+                        std::cos(pi * double(k+1)/double(Nr));
+    });
+    popRegion();
+
+    fence();  // Ensure initialization is complete before timing
+
+    // Interior columns need no halo data: their stencil stays within the
+    // columns this rank owns.  Everything else is boundary.
+    std::vector<int> interior_host, boundary_host;
+    for (int jj = 0; jj < t.nyt(); jj++) {
+      for (int ii = 0; ii < t.nxt(); ii++) {
+        const int i = ii - t.OL;
+        const int j = jj - t.OL;
+        const bool interior = i >= 1 && i < t.sNx-1 && j >= 1 && j < t.sNy-1;
+        (interior ? interior_host : boundary_host).push_back(t.col(i,j));
+      }
+    }
+    View<int*, MemSpace> interior_cols("interior_cols", interior_host.size());
+    View<int*, MemSpace> boundary_cols("boundary_cols", boundary_host.size());
+    deep_copy(interior_cols, View<const int*, HostSpace, MemoryUnmanaged>(interior_host.data(), interior_host.size()));
+    deep_copy(boundary_cols, View<const int*, HostSpace, MemoryUnmanaged>(boundary_host.data(), boundary_host.size()));
+    const int n_interior = int(interior_host.size());
+    const int n_boundary = int(boundary_host.size());
+
+    // Separate instances for interior and boundary work, only with --split
+    std::vector<ExecSpace> instances;
+    if (split) instances = Experimental::partition_space(ExecSpace(), std::vector<int>{1, 1});
+
+    auto a_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(a);
+    auto b_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(b);
+    auto c_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(c);
+
+    MPI_Barrier(d.comm);
+    halo.reset_timer();  // only the exchanges of the timed steps count
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int step = 0; step < steps; step++) {
+      if (split) {
+        const ExecSpace& interior_exec = instances[0];
+        const ExecSpace& boundary_exec = instances[1];
+        auto interior_step = [&] {
+          horizontal_smooth(interior_exec, n_interior, Nr, ColumnList{interior_cols}, t, nu, y, y_new);
+          solve_tridiagonal_kokkos_optimized(interior_exec, interior_cols, Nr, a_const, b_const, c_const, y_new);
+        };
+        auto boundary_step = [&] {
+          horizontal_smooth(boundary_exec, n_boundary, Nr, ColumnList{boundary_cols}, t, nu, y, y_new);
+          solve_tridiagonal_kokkos_optimized(boundary_exec, boundary_cols, Nr, a_const, b_const, c_const, y_new);
+        };
+        if (threaded_split) {
+          std::thread boundary([&] {
+            halo.begin_xyz(boundary_exec, y);
+            halo.end_xyz(boundary_exec, y);
+            boundary_step();
+            boundary_exec.fence("boundary");
+          });
+          interior_step();
+          interior_exec.fence("interior");
+          boundary.join();
+        } else {
+          halo.begin_xyz(boundary_exec, y);
+          interior_step();
+          halo.end_xyz(boundary_exec, y);
+          boundary_step();
+          interior_exec.fence("interior");
+          boundary_exec.fence("boundary");
+        }
+      } else {
+        halo.exch_xyz(y);
+        horizontal_smooth(ExecSpace(), ncols, Nr, AllColumns{}, t, nu, y, y_new);
+        // Implicit vertical solve on every column of the tile, overlap included
+        solve_tridiagonal_kokkos_optimized(ncols, Nr, a_const, b_const, c_const, y_new);
+      }
+      std::swap(y, y_new);
+    }
+
+    fence();
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double>(end - start).count();
+    double comm = halo.seconds();
+    double max_elapsed = 0.0, max_comm = 0.0;
+    MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, d.comm);
+    MPI_Reduce(&comm, &max_comm, 1, MPI_DOUBLE, MPI_MAX, 0, d.comm);
+
+    if (d.rank == 0 && steps > 0) {
+      std::cerr << "Time per iteration: " << std::fixed << std::setprecision(4)
+                << max_elapsed / steps << " seconds" << std::endl;
+      std::cerr << "Halo exchange time per iteration: " << std::fixed << std::setprecision(4)
+                << max_comm / steps << " seconds" << std::endl;
+    }
+
+    // Gather the tile interiors on rank 0 and write CSV
+    auto h_y = create_mirror_view_and_copy(HostSpace{}, y);
+    const int tile_count = t.sNx * t.sNy * Nr;
+    std::vector<double> local(tile_count);
+    for (int j = 0; j < t.sNy; j++) {
+      for (int i = 0; i < t.sNx; i++) {
+        for (int k = 0; k < Nr; k++) {
+          local[k + Nr * (i + t.sNx * j)] = h_y(t.col(i,j),k);
+        }
+      }
+    }
+    std::vector<double> gathered(d.rank == 0 ? size_t(tile_count) * d.nranks : 0);
+    MPI_Gather(local.data(), tile_count, MPI_DOUBLE, gathered.data(), tile_count, MPI_DOUBLE, 0, d.comm);
+
+    if (d.rank == 0) {
+      std::vector<double> global(size_t(nx) * ny * Nr);
+      for (int r = 0; r < d.nranks; r++) {
+        int coords[2];
+        MPI_Cart_coords(d.comm, r, 2, coords);
+        const double* tile = gathered.data() + size_t(r) * tile_count;
+        for (int j = 0; j < t.sNy; j++) {
+          for (int i = 0; i < t.sNx; i++) {
+            const size_t gi = size_t(coords[0]) * t.sNx + i;
+            const size_t gj = size_t(coords[1]) * t.sNy + j;
+            for (int k = 0; k < Nr; k++) {
+              global[(gi + nx * gj) * Nr + k] = tile[k + Nr * (i + t.sNx * j)];
+            }
+          }
+        }
+      }
+
+      for (size_t col = 0; col < size_t(nx) * ny; col++) {
+        for (int k = 0; k < Nr; k++) {
+          std::cout << std::fixed << std::setprecision(10) << global[col * Nr + k];
+          if (k < Nr-1) std::cout << ",";
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+  finalize();
+
+  MPI_Comm_free(&d.comm);
+  MPI_Finalize();
+  return 0;
+}
@@ -3,79 +3,20 @@
 #include <chrono>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
 
-using namespace Kokkos;
-
-// Optimized memory layout and traits for GPU performance
-using Layout = LayoutLeft;  // Explicit layout for coalesced access
-using MemSpace = DefaultExecutionSpace::memory_space;
-using ExecSpace = DefaultExecutionSpace;
-
-// Memory traits for read-only data (enables texture cache on GPU)
-using ReadOnlyTraits = MemoryTraits<RandomAccess>;
+#include "coefficient_views.hpp"
+#include "column_depth.hpp"
+#include "column_layouts.hpp"
+#include "column_screening.hpp"
+#include "huge_page_alloc.hpp"
+#include "numa_topology.hpp"
+#include "thomas_solver.hpp"
 
-// Profiling stubs for compatibility
-inline void pushRegion(const char*) {}
-inline void popRegion() {}
-
-void solve_tridiagonal_kokkos_optimized(int ni, int nk, 
-                                       View<const double**, Layout, MemSpace, ReadOnlyTraits> a,
-                                       View<const double**, Layout, MemSpace, ReadOnlyTraits> b,
-                                       View<const double**, Layout, MemSpace, ReadOnlyTraits> c,
-                                       View<double**, Layout, MemSpace> y) {
-  
-  pushRegion("thomas_solver_optimized");
-  
-  // Single TeamPolicy kernel with scratch memory - eliminates O(nk) launch overhead
-  TeamPolicy<ExecSpace> policy(ni, Kokkos::AUTO);
-  
-  // Allocate scratch memory for temporaries (c_prime, y_prime)
-  policy.set_scratch_size(0, PerTeam(2 * nk * sizeof(double)));
-  
-  parallel_for("thomas_algorithm_single_kernel", policy,
-    KOKKOS_LAMBDA(const TeamPolicy<ExecSpace>::member_type& team) {
-      
-      int i = team.league_rank();
-      
-      // Get scratch memory for this team
-      double* c_prime = (double*)team.team_scratch(0).get_shmem(nk * sizeof(double));
-      double* y_prime = (double*)team.team_scratch(0).get_shmem(nk * sizeof(double), nk * sizeof(double));
-      
-      // Forward sweep - first element
-      if (b(i,0) != 0.0) {
-        double recVar = 1.0 / b(i,0);
-        c_prime[0] = c(i,0) * recVar;
-        y_prime[0] = y(i,0) * recVar;
-      } else {
-        c_prime[0] = 0.0;
-        y_prime[0] = 0.0;
-      }
-      
-      // Forward sweep - sequential k-loop within team (no kernel launch overhead)
-      for (int k = 1; k < nk; k++) {
-        double tmpVar = b(i,k) - a(i,k) * c_prime[k-1];
-        if (tmpVar != 0.0) {
-          double recVar = 1.0 / tmpVar;
-          c_prime[k] = c(i,k) * recVar;
-          y_prime[k] = (y(i,k) - a(i,k) * y_prime[k-1]) * recVar;
-        } else {
-          c_prime[k] = 0.0;
-          y_prime[k] = 0.0;
-        }
-      }
-      
-      // Backward sweep - last element
-      y(i,nk-1) = y_prime[nk-1];
-      
-      // Backward sweep - sequential k-loop within team
-      for (int k = nk-2; k >= 0; k--) {
-        y(i,k) = y_prime[k] - c_prime[k] * y(i,k+1);
-      }
-    }
-  );
-  
-  popRegion();
-}
+using namespace Kokkos;
 
 void solve_tridiagonal_kokkos_naive(int ni, int nk, 
                                    View<double**, Layout, MemSpace> a, 
@@ -135,35 +76,388 @@ void solve_tridiagonal_kokkos_naive(int ni, int nk,
   popRegion();
 }
 
+// Optimized solver on copies of a, b, c, y stored with `Storage`; returns the
+// time per iteration (reset + solve) and leaves the solution in y_out.  Launch
+// parameters are tuned and cached per layout, since the best team shape
+// depends on it.
+template <class Storage>
+double benchmark_layout(int n, int nk, int reps, tuning::LaunchTuner& tuner,
+                        View<double**, Layout, MemSpace> a, View<double**, Layout, MemSpace> b,
+                        View<double**, Layout, MemSpace> c, View<double**, Layout, MemSpace> y,
+                        View<double**, Layout, MemSpace> y_out) {
+  const auto coefs = Storage::allocate_coefficients(n, nk);
+  auto s_y0 = Storage::allocate("y0_layout", n, nk);
+  auto s_y = Storage::allocate("y_layout", n, nk);
+  pack_coefficients(ExecSpace(), n, nk, a, b, c, coefs);
+  parallel_for_solver_columns("copy_to_layout", ExecSpace(), n, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+    for (int k = 0; k < nk; k++) {
+      s_y0(i,k) = y(i,k);
+      s_y(i,k) = 0.0;
+    }
+  });
+  typename Storage::ConstMatrix a_const(coefs[0]), b_const(coefs[1]), c_const(coefs[2]);
+  
+  auto run = [&](const tuning::LaunchParams& p) {
+    parallel_for_solver_columns("reset_y_layout", ExecSpace(), n, p, KOKKOS_LAMBDA(int i) {
+      for (int k = 0; k < nk; k++) s_y(i,k) = s_y0(i,k);
+    });
+    solve_tridiagonal_columns(ExecSpace(), n, nk, AllColumns{}, a_const, b_const, c_const, s_y, p);
+  };
+  const tuning::LaunchParams launch =
+      tuner.select(std::string("thomas_solver_optimized/") + Storage::name, long(n) * nk, tuning::LaunchParams{},
+                   tuning::team_candidates(ExecSpace().concurrency()), run);
+  
+  for (int warmup = 0; warmup < 3; warmup++) run(launch);
+  fence();
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int rep = 0; rep < reps; rep++) run(launch);
+  fence();
+  auto end = std::chrono::high_resolution_clock::now();
+  
+  parallel_for_solver_columns("copy_from_layout", ExecSpace(), n, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+    for (int k = 0; k < nk; k++) y_out(i,k) = s_y(i,k);
+  });
+  fence();
+  return std::chrono::duration<double>(end - start).count() / reps;
+}
+
+// Self-check of the level-only coefficient form: a system whose main
+// diagonal is a vertical profile is solved once with b as a LevelCoefficient
+// and once with the profile broadcast into a full View.  Both read the same
+// values, so the solutions must agree bit for bit; returns the largest
+// difference.
+double check_level_coefficient(const ExecSpace& exec, int n, int nk, const tuning::LaunchParams& launch) {
+  constexpr double pi = 3.141592653589793;
+  View<double*, MemSpace> profile("b_profile", nk);
+  View<double**, Layout, MemSpace> b_full(view_alloc(WithoutInitializing, "b_profile_full"), n, nk);
+  View<double**, Layout, MemSpace> y_level(view_alloc(WithoutInitializing, "y_level"), n, nk);
+  View<double**, Layout, MemSpace> y_full(view_alloc(WithoutInitializing, "y_full"), n, nk);
+  parallel_for("init_profile", RangePolicy<ExecSpace>(exec, 0, nk), KOKKOS_LAMBDA(int k) {
+    profile(k) = 2.0 + 0.1 * std::cos(pi * double(k+1) / double(nk));
+  });
+  parallel_for_solver_columns("init_level_check", exec, n, launch, KOKKOS_LAMBDA(int i) {
+    for (int k = 0; k < nk; k++) {
+      b_full(i,k) = 2.0 + 0.1 * std::cos(pi * double(k+1) / double(nk));
+      y_level(i,k) = std::sin(pi * double(i+1) / double(n)) * std::cos(pi * double(k+1) / double(nk));
+      y_full(i,k) = y_level(i,k);
+    }
+  });
+  solve_tridiagonal_columns(exec, n, nk, AllColumns{}, ConstantCoefficient{-0.5}, LevelCoefficient{profile},
+                            ConstantCoefficient{-0.5}, y_level, launch);
+  solve_tridiagonal_columns(exec, n, nk, AllColumns{}, ConstantCoefficient{-0.5}, FullCoefficient(b_full),
+                            ConstantCoefficient{-0.5}, y_full, launch);
+  double max_diff = 0.0;
+  parallel_reduce("level_check_diff", RangePolicy<ExecSpace>(exec, 0, n), KOKKOS_LAMBDA(int i, double& worst) {
+    for (int k = 0; k < nk; k++) worst = std::max(worst, std::abs(y_level(i,k) - y_full(i,k)));
+  }, Max<double>(max_diff));
+  return max_diff;
+}
+
+// Backward Euler rows of the vertical diffusion operator for tracer T with
+// uniform layers: the diffusivity at interface k (between levels k-1 and k) is
+// a background profile plus convective mixing wherever the column is
+// statically unstable there, as in MITgcm's implicit convection.  The
+// interfaces at the top and bottom of each column's levels (FullDepth or a
+// ColumnDepth) are closed.
+template <class Levels>
+struct VerticalDiffusionRows {
+  View<const double*, MemSpace> kappa_bg;
+  View<const double**, Layout, MemSpace> T;
+  Levels levels;
+  double r;           // dt / dz^2
+  double kappa_conv;
+  
+  KOKKOS_INLINE_FUNCTION double kappa(int i, int k) const {
+    if (k <= levels.first(i) || k >= levels.last(i)) return 0.0;
+    return kappa_bg(k) + ((T(i,k) > T(i,k-1)) ? kappa_conv : 0.0);
+  }
+  KOKKOS_INLINE_FUNCTION TridiagonalRow<double> operator()(int i, int k) const {
+    const double kappa_above = kappa(i, k);
+    const double kappa_below = kappa(i, k + 1);
+    return {-r * kappa_above, 1.0 + r * (kappa_above + kappa_below), -r * kappa_below};
+  }
+};
+
+// Sea floor of the variable bathymetry as a fraction of the full depth: a
+// rough ridge, above sea level (<= 0) on about a third of the columns
+KOKKOS_INLINE_FUNCTION double ridge_depth(int i, int n) {
+  constexpr double pi = 3.141592653589793;
+  const double x = (i + 0.5) / n;
+  return std::sin(3.0 * pi * x) + 0.2 * std::sin(37.0 * pi * x);
+}
+
+// Implicit vertical diffusion of a tracer T over `steps` timesteps with no
+// flux through the surface and bottom; the coefficients depend on T, so each
+// step sees different ones.  Unfused, every step writes a, b, c from
+// VerticalDiffusionRows and then solves for the new T in place; fused, the
+// solver evaluates the rows inside its sweep and a, b, c never reach memory.
+// With variable bathymetry about a third of the columns are land and the wet
+// ones have from 1 to nk levels; every column kernel then visits the cached
+// wet-column list and the solver its depth bins (column_depth.hpp), and T
+// stays 0 on dry levels.  Halfway through, a sea-level rise floods the land
+// next to the coast with one level of water at T = 0; the mask changes, so the
+// wet-column lists are rebuilt once more.  All of it is issued on `exec` and stays on the
+// device; returns the time per step.
+double run_vertical_diffusion(const ExecSpace& exec, int n, int nk, int steps, bool fused, bool variable_depth,
+                              const tuning::LaunchParams& launch, View<double**, Layout, MemSpace> T) {
+  constexpr double pi = 3.141592653589793;
+  constexpr double dt = 3600.0;          // s
+  constexpr double dz = 10.0;            // m, uniform levels
+  constexpr double kappa_conv = 10.0;    // m^2/s, convective mixing
+  
+  View<double*, MemSpace> kappa_bg("kappa_background", nk + 1);
+  View<double*, MemSpace> heat0("initial_heat_content", n);
+  parallel_for("init_kappa", RangePolicy<ExecSpace>(exec, 0, nk + 1), KOKKOS_LAMBDA(int k) {
+    kappa_bg(k) = 1.0e-5 + 1.0e-3 * std::exp(-double(k) / 5.0);
+  });
+  
+  // Bathymetry: wet from the surface down to k_high(i), which follows a
+  // rough ridge and is 0 (land) where the ridge is above sea level
+  View<int*, MemSpace> k_low("k_low", n);
+  View<int*, MemSpace> k_high(view_alloc(WithoutInitializing, "k_high"), n);
+  parallel_for("init_bathymetry", RangePolicy<ExecSpace>(exec, 0, n), KOKKOS_LAMBDA(int i) {
+    const double depth = ridge_depth(i, n);
+    k_high(i) = !variable_depth ? nk : (depth <= 0.0) ? 0 : std::min(nk, 1 + int(nk * depth));
+  });
+  const ColumnDepth column_depth{k_low, k_high};
+  int mask_version = 0;  // bumped whenever k_low / k_high are rewritten
+  WetColumns wet;
+  if (variable_depth) {
+    wet.update(exec, n, nk, column_depth, mask_version);
+    std::cerr << "Bathymetry: " << wet.count() << " of " << n << " columns wet, " << wet.bins().wet_levels() << " of "
+              << long(n) * nk << " levels" << std::endl;
+  }
+  // Runs f(i) for the wet columns only, or for all of them with flat bathymetry
+  auto for_wet_columns = [&](const char* label, auto f) {
+    if (variable_depth) {
+      parallel_for_solver_columns(label, exec, wet.count(), wet.columns(), launch, f);
+    } else {
+      parallel_for_solver_columns(label, exec, n, launch, f);
+    }
+  };
+  
+  // Warm surface over cold deep water, with a mid-depth warm anomaly that
+  // makes part of every column unstable until convection removes it.  Land
+  // columns are zeroed once here and only visited again once flooded.
+  if (variable_depth) deep_copy(exec, T, 0.0);
+  for_wet_columns("init_tracer", KOKKOS_LAMBDA(int i) {
+    double heat = 0.0;
+    for (int k = 0; k < nk; k++) {
+      const double bump = (k - 0.5 * nk) / 3.0;
+      const bool wet = (k >= column_depth.first(i) && k < column_depth.last(i));
+      T(i,k) = !wet ? 0.0 : 20.0 * std::cos(0.5 * pi * (k + 0.5) / nk) + 4.0 * std::sin(pi * double(i+1) / double(n)) * std::exp(-bump * bump);
+      heat += T(i,k);
+    }
+    heat0(i) = heat;
+  });
+  
+  // Assembled coefficients, only needed unfused
+  View<double**, Layout, MemSpace> a, b, c;
+  if (!fused) {
+    auto alloc = [&](const char* label) { return View<double**, Layout, MemSpace>(view_alloc(WithoutInitializing, label), n, nk); };
+    a = alloc("a_diffusion");
+    b = alloc("b_diffusion");
+    c = alloc("c_diffusion");
+  }
+  exec.fence("init_vertical_diffusion");
+  
+  // One step for the column levels `levels` (FullDepth or column_depth)
+  FullCoefficient a_const(a), b_const(b), c_const(c);
+  auto step = [&](auto levels) {
+    const VerticalDiffusionRows<decltype(levels)> rows{kappa_bg, T, levels, dt / (dz * dz), kappa_conv};
+    auto solve = [&](auto solve_rows) {
+      if constexpr (std::is_same_v<decltype(levels), FullDepth>) {
+        solve_tridiagonal_fused(exec, n, nk, AllColumns{}, solve_rows, T, launch);
+      } else {
+        solve_tridiagonal_binned(exec, wet.bins(), levels, solve_rows, T, launch);
+      }
+    };
+    if (fused) {
+      solve(rows);
+      return;
+    }
+    for_wet_columns("assemble_diffusion", KOKKOS_LAMBDA(int i) {
+      for (int k = levels.first(i); k < levels.last(i); k++) {
+        const TridiagonalRow<double> row = rows(i, k);
+        a(i,k) = row.a;
+        b(i,k) = row.b;
+        c(i,k) = row.c;
+      }
+    });
+    solve(SeparateCoefficients<FullCoefficient, FullCoefficient, FullCoefficient>{a_const, b_const, c_const});
+  };
+  
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int t = 0; t < steps; t++) {
+    if (variable_depth) {
+      if (t == steps / 2 && t > 0) {
+        // Flooded columns start at T = 0, so every column keeps its heat content
+        parallel_for("flood_coast", RangePolicy<ExecSpace>(exec, 0, n), KOKKOS_LAMBDA(int i) {
+          if (k_high(i) == 0 && ridge_depth(i, n) > -0.1) k_high(i) = 1;
+        });
+        mask_version++;
+      }
+      wet.update(exec, n, nk, column_depth, mask_version);  // no-op until the mask changes
+      step(column_depth);
+    } else {
+      step(FullDepth{nk});
+    }
+  }
+  exec.fence("vertical_diffusion");
+  auto end = std::chrono::high_resolution_clock::now();
+  
+  // No-flux boundaries conserve every column's heat content
+  double drift = 0.0;
+  parallel_reduce("heat_drift", RangePolicy<ExecSpace>(exec, 0, n), KOKKOS_LAMBDA(int i, double& worst) {
+    double heat = 0.0;
+    for (int k = 0; k < nk; k++) heat += T(i,k);
+    if (heat0(i) != 0.0) worst = std::max(worst, std::abs(heat - heat0(i)) / std::abs(heat0(i)));
+  }, Max<double>(drift));
+  std::cerr << "Max relative heat content drift: " << std::scientific << std::setprecision(3) << drift
+            << std::defaultfloat << std::endl;
+  if (variable_depth) {
+    std::cerr << "Wet column lists built " << wet.rebuilds() << " time(s) over " << steps << " steps" << std::endl;
+  }
+  
+  return std::chrono::duration<double>(end - start).count() / steps;
+}
+
 int main(int argc, char* argv[]) {
   if (argc < 4) {
     std::cerr << "Usage: " << argv[0] << " <n> <reps> <impl>" << std::endl;
-    std::cerr << "  impl: naive|optimized|both" << std::endl;
+    std::cerr << "  impl: naive|optimized|both|layouts|diffusion" << std::endl;
+    std::cerr << "  (diffusion: implicit vertical diffusion over --steps <T> timesteps, default reps)" << std::endl;
+    std::cerr << "  (layouts: optimized solver on LayoutLeft, LayoutRight, " << kTileColumns
+              << "-column tiles and packed a/b/c tiles, reporting the fastest)" << std::endl;
+    std::cerr << "  options: --tune  --tuning-cache <path>  --instances <k>  --first-touch solver|kokkos" << std::endl;
+    std::cerr << "           --alloc default|aligned|hugepage  --coefficients full|compressed|fused" << std::endl;
+    std::cerr << "           (fused: diffusion only, a/b/c computed inside the solver sweep)" << std::endl;
+    std::cerr << "           --bathymetry flat|variable  (diffusion only; variable: land and varying column depth)"
+              << std::endl;
+    std::cerr << "           --precision fp64|fp32|mixed  (mixed: fp32 storage, fp64 sweeps)" << std::endl;
+    std::cerr << "           --screen  (branch-free sweep on diagonally dominant columns, pivoting on the rest)"
+              << std::endl;
+    std::cerr << "           --check  (with --coefficients compressed: verify the level-only form against full Views)"
+              << std::endl;
     return 1;
   }
   
   int n = std::atoi(argv[1]);
   int reps = std::atoi(argv[2]);
   std::string impl = argv[3];
+  int instances = 1;  // execution space partitions for the optimized solver
+  // solver: Views are first touched with the solver's column partitioning;
+  // kokkos: Kokkos' zero fill and the MDRange init kernel touch them first
+  std::string first_touch = "solver";
+  // Backing of the solver arrays on host backends (see huge_page_alloc.hpp)
+  hugepage::Mode alloc_mode = hugepage::Mode::Default;
+  // compressed: the optimized solver gets the constant off-diagonals as
+  // scalars and streams only b and y; fused: the diffusion solve computes its
+  // coefficients inside the sweep
+  std::string coefficients = "full";
+  // Storage / sweep precision of the optimized solver
+  std::string precision = "fp64";
+  bool screen = false;
+  bool check = false;  // verification solves outside the timed path
+  int steps = 0;  // diffusion timesteps; 0 means reps
+  std::string bathymetry = "flat";
+  for (int i = 4; i < argc; i++) {
+    if (std::string(argv[i]) == "--screen") screen = true;
+    if (std::string(argv[i]) == "--check") check = true;
+    if (i + 1 == argc) break;
+    if (std::string(argv[i]) == "--instances") instances = std::max(1, std::atoi(argv[i+1]));
+    if (std::string(argv[i]) == "--first-touch") first_touch = argv[i+1];
+    if (std::string(argv[i]) == "--coefficients") coefficients = argv[i+1];
+    if (std::string(argv[i]) == "--precision") precision = argv[i+1];
+    if (std::string(argv[i]) == "--steps") steps = std::atoi(argv[i+1]);
+    if (std::string(argv[i]) == "--bathymetry") bathymetry = argv[i+1];
+    if (std::string(argv[i]) == "--alloc" && !hugepage::parse_mode(argv[i+1], alloc_mode)) {
+      std::cerr << "Error: unknown allocation mode '" << argv[i+1] << "'" << std::endl;
+      return 1;
+    }
+  }
+  if (first_touch != "solver" && first_touch != "kokkos") {
+    std::cerr << "Error: unknown first-touch mode '" << first_touch << "'" << std::endl;
+    return 1;
+  }
+  if (coefficients != "full" && coefficients != "compressed" && coefficients != "fused") {
+    std::cerr << "Error: unknown coefficients '" << coefficients << "'" << std::endl;
+    return 1;
+  }
+  if (coefficients == "fused" && impl != "diffusion") {
+    std::cerr << "Error: --coefficients fused requires impl diffusion" << std::endl;
+    return 1;
+  }
+  const bool compressed = (coefficients == "compressed");
+  if (check && !compressed) {
+    std::cerr << "Error: --check requires --coefficients compressed" << std::endl;
+    return 1;
+  }
+  if (bathymetry != "flat" && bathymetry != "variable") {
+    std::cerr << "Error: unknown bathymetry '" << bathymetry << "'" << std::endl;
+    return 1;
+  }
+  if (precision != "fp64" && precision != "fp32" && precision != "mixed") {
+    std::cerr << "Error: unknown precision '" << precision << "'" << std::endl;
+    return 1;
+  }
+  const bool fp32_storage = (precision != "fp64");
+  if (screen && instances > 1) {
+    std::cerr << "Error: --screen does not support --instances" << std::endl;
+    return 1;
+  }
+  // The diffusion mode has its own coefficients and a single solver instance
+  if (impl == "diffusion") {
+    const char* unsupported = compressed ? "--coefficients compressed"
+                              : fp32_storage ? "--precision fp32|mixed"
+                              : screen ? "--screen"
+                              : (instances > 1) ? "--instances"
+                              : nullptr;
+    if (unsupported != nullptr) {
+      std::cerr << "Error: " << unsupported << " is not supported with impl diffusion" << std::endl;
+      return 1;
+    }
+  } else if (bathymetry != "flat" || steps > 0) {
+    std::cerr << "Error: " << (steps > 0 ? "--steps" : "--bathymetry variable") << " requires impl diffusion"
+              << std::endl;
+    return 1;
+  }
   
   // Initialize Kokkos
+  int status = 0;
   initialize(argc, argv);
   {
     constexpr int Nr = 50;  // vertical levels (typical MITgcm)
     constexpr double pi = 3.141592653589793;
     
-    // Allocate Views with optimized layout
-    View<double**, Layout, MemSpace> a("a", n, Nr);
-    View<double**, Layout, MemSpace> b("b", n, Nr);
-    View<double**, Layout, MemSpace> c("c", n, Nr);
-    View<double**, Layout, MemSpace> y("y", n, Nr);
-    View<double**, Layout, MemSpace> y_naive("y_naive", n, Nr);
-    View<double**, Layout, MemSpace> y_optimized("y_optimized", n, Nr);
+    numa::report_topology(std::cerr);
+    
+    // Allocate Views with optimized layout.  In solver mode nothing is written
+    // until init_matrices, so the first touch of every page is by the thread
+    // that solves its columns.
+    const bool solver_first_touch = (first_touch == "solver");
+    hugepage::Arena arena(alloc_mode);  // declared before, so it outlives, the Views
+    if (alloc_mode != hugepage::Mode::Default && !arena.serves<View<double**, Layout, MemSpace>>()) {
+      std::cerr << "Note: --alloc " << hugepage::mode_name(alloc_mode) << " applies to host memory only" << std::endl;
+    }
+    auto alloc = [&](const char* label) {
+      if (arena.serves<View<double**, Layout, MemSpace>>()) {
+        auto v = arena.matrix<View<double**, Layout, MemSpace>>(label, n, Nr);
+        if (!solver_first_touch) deep_copy(v, 0.0);  // same first touch as Kokkos' zero fill
+        return v;
+      }
+      return solver_first_touch ? View<double**, Layout, MemSpace>(view_alloc(WithoutInitializing, label), n, Nr)
+                                : View<double**, Layout, MemSpace>(label, n, Nr);
+    };
+    View<double**, Layout, MemSpace> a = alloc("a");
+    View<double**, Layout, MemSpace> b = alloc("b");
+    View<double**, Layout, MemSpace> c = alloc("c");
+    View<double**, Layout, MemSpace> y = alloc("y");
+    View<double**, Layout, MemSpace> y_naive = alloc("y_naive");
+    View<double**, Layout, MemSpace> y_optimized = alloc("y_optimized");
     
     // Initialize test matrices - tridiagonal system for heat diffusion
-    pushRegion("initialization");
-    parallel_for("init_matrices", MDRangePolicy<Rank<2>>({0,0}, {n,Nr}), 
-                 KOKKOS_LAMBDA(int i, int k) {
+    auto init_element = KOKKOS_LAMBDA(int i, int k) {
       // Lower diagonal (except first row)
       if (k > 0) {
         a(i,k) = -0.5;
@@ -183,10 +477,123 @@ int main(int argc, char* argv[]) {
       
       // RHS - some test function
       y(i,k) = std::sin(pi * double(i+1)/double(n)) * std::cos(pi * double(k+1)/double(Nr));
-    });
+    };
+    pushRegion("initialization");
+    if (solver_first_touch) {
+      // Default launch parameters: with the static schedule every thread owns
+      // the same contiguous column block whatever the tuned team shape
+      parallel_for_solver_columns("init_matrices", ExecSpace(), n, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+        for (int k = 0; k < Nr; k++) {
+          init_element(i, k);
+          y_naive(i,k) = 0.0;
+          y_optimized(i,k) = 0.0;
+        }
+      });
+    } else {
+      parallel_for("init_matrices", MDRangePolicy<Rank<2>>({0,0}, {n,Nr}), init_element);
+    }
     popRegion();
     
     fence();  // Ensure initialization is complete before timing
+    if (arena.serves<View<double**, Layout, MemSpace>>() && hugepage::anon_huge_pages_kb() >= 0) {
+      std::cerr << "AnonHugePages after initialization: " << hugepage::anon_huge_pages_kb() << " kB" << std::endl;
+    }
+    
+    // Launch parameters: searched with --tune, otherwise loaded from the cache
+    tuning::LaunchTuner tuner = tuning::LaunchTuner::from_args(argc, argv);
+    tuning::LaunchParams thomas_launch;
+    if (impl == "optimized" || impl == "both" || impl == "diffusion") {
+      auto a_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(a);
+      auto b_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(b);
+      auto c_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(c);
+      thomas_launch = tuner.select("thomas_solver_optimized", long(n) * Nr, tuning::LaunchParams{},
+                                   tuning::team_candidates(ExecSpace().concurrency()),
+                                   [&](const tuning::LaunchParams& p) {
+                                     deep_copy(y_optimized, y);
+                                     solve_tridiagonal_kokkos_optimized(n, Nr, a_const, b_const, c_const, y_optimized, p);
+                                   });
+    }
+    
+    // With --instances the columns are split into independent groups, each
+    // solved on its own partition of the execution space
+    std::vector<ExecSpace> partitions;
+    if (instances > 1) {
+      partitions = Experimental::partition_space(ExecSpace(), std::vector<int>(instances, 1));
+      std::cerr << "Optimized solver on " << instances << " execution space instances" << std::endl;
+    }
+    // fp32 storage for --precision fp32|mixed: converted copies of the inputs,
+    // and the solution, which is widened into y_optimized for output
+    View<float**, Layout, MemSpace> a32, b32, c32, y32, y_opt32;
+    if (fp32_storage) {
+      a32 = View<float**, Layout, MemSpace>(view_alloc(WithoutInitializing, "a32"), n, Nr);
+      b32 = View<float**, Layout, MemSpace>(view_alloc(WithoutInitializing, "b32"), n, Nr);
+      c32 = View<float**, Layout, MemSpace>(view_alloc(WithoutInitializing, "c32"), n, Nr);
+      y32 = View<float**, Layout, MemSpace>(view_alloc(WithoutInitializing, "y32"), n, Nr);
+      y_opt32 = View<float**, Layout, MemSpace>(view_alloc(WithoutInitializing, "y_optimized32"), n, Nr);
+      parallel_for_solver_columns("narrow_to_fp32", ExecSpace(), n, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+        for (int k = 0; k < Nr; k++) {
+          a32(i,k) = float(a(i,k));
+          b32(i,k) = float(b(i,k));
+          c32(i,k) = float(c(i,k));
+          y32(i,k) = float(y(i,k));
+          y_opt32(i,k) = 0.0f;
+        }
+      });
+      fence();
+    }
+    
+    // With --screen, columns are checked for diagonal dominance once: the
+    // dominant ones get the branch-free sweep, the rest the pivoting fallback.
+    // The check runs on the coefficients actually solved, i.e. the rounded
+    // copies under fp32 storage.
+    ColumnScreen column_screen;
+    if (screen) {
+      using Float32Coefficient = View<const float**, Layout, MemSpace, ReadOnlyTraits>;
+      column_screen = fp32_storage
+          ? screen_columns(ExecSpace(), n, Nr, Float32Coefficient(a32), Float32Coefficient(b32), Float32Coefficient(c32))
+          : screen_columns(ExecSpace(), n, Nr, FullCoefficient(a), FullCoefficient(b), FullCoefficient(c));
+      std::cerr << "Screened columns: " << n - column_screen.rerouted_count() << " diagonally dominant, "
+                << column_screen.rerouted_count() << " rerouted to the pivoting fallback" << std::endl;
+    }
+    
+    // Issues the reset of y_opt and the optimized solve on `exec` without
+    // waiting; with partitions the solve itself waits on the partition fences.
+    // The sweeps accumulate in the type of `accum`.
+    auto solve_optimized = [&](const ExecSpace& exec, View<double**, Layout, MemSpace> y_opt) {
+      auto solve = [&](auto accum, auto a_opt, auto b_opt, auto c_opt, auto y_solve) {
+        using Accum = decltype(accum);
+        if (screen) {
+          solve_tridiagonal_screened<Accum>(exec, column_screen, a_opt, b_opt, c_opt, y_solve, thomas_launch);
+        } else if (partitions.empty()) {
+          solve_tridiagonal_columns<Accum>(exec, n, Nr, AllColumns{}, a_opt, b_opt, c_opt, y_solve, thomas_launch);
+        } else {
+          exec.fence("reset_y_optimized");
+          solve_tridiagonal_kokkos_partitioned<Accum>(partitions, n, Nr, a_opt, b_opt, c_opt, y_solve, thomas_launch);
+        }
+      };
+      // a and c are -0.5 apart from a(i,0) and c(i,Nr-1), which the solver
+      // ignores, so --coefficients compressed passes them as scalars
+      auto solve_coefficients = [&](auto accum, auto a_full, auto b_full, auto c_full, auto y_solve) {
+        if (compressed) {
+          solve(accum, ConstantCoefficient{-0.5}, b_full, ConstantCoefficient{-0.5}, y_solve);
+        } else {
+          solve(accum, a_full, b_full, c_full, y_solve);
+        }
+      };
+      if (!fp32_storage) {
+        deep_copy(exec, y_opt, y);
+        solve_coefficients(double{}, FullCoefficient(a), FullCoefficient(b), FullCoefficient(c), y_opt);
+        return;
+      }
+      using Float32Coefficient = View<const float**, Layout, MemSpace, ReadOnlyTraits>;
+      deep_copy(exec, y_opt32, y32);
+      if (precision == "mixed") {
+        solve_coefficients(double{}, Float32Coefficient(a32), Float32Coefficient(b32), Float32Coefficient(c32), y_opt32);
+      } else {
+        solve_coefficients(float{}, Float32Coefficient(a32), Float32Coefficient(b32), Float32Coefficient(c32), y_opt32);
+      }
+    };
+    ExecSpace solver_exec;
     
     // Warmup iterations
     for (int warmup = 0; warmup < 3; warmup++) {
@@ -195,12 +602,7 @@ int main(int argc, char* argv[]) {
         solve_tridiagonal_kokkos_naive(n, Nr, a, b, c, y_naive);
       }
       if (impl == "optimized" || impl == "both") {
-        deep_copy(y_optimized, y);
-        // Create const views with ReadOnly traits for optimized version
-        auto a_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(a);
-        auto b_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(b);
-        auto c_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(c);
-        solve_tridiagonal_kokkos_optimized(n, Nr, a_const, b_const, c_const, y_optimized);
+        solve_optimized(solver_exec, y_optimized);
       }
     }
     fence();
@@ -225,26 +627,34 @@ int main(int argc, char* argv[]) {
     
     // Benchmark optimized implementation
     if (impl == "optimized" || impl == "both") {
-      // Create const views with ReadOnly traits
-      auto a_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(a);
-      auto b_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(b);
-      auto c_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(c);
-      
       auto start_optimized = std::chrono::high_resolution_clock::now();
       
       for (int rep = 0; rep < reps; rep++) {
-        deep_copy(y_optimized, y);
-        solve_tridiagonal_kokkos_optimized(n, Nr, a_const, b_const, c_const, y_optimized);
+        solve_optimized(solver_exec, y_optimized);
       }
       
-      fence();
+      solver_exec.fence("optimized_benchmark");
       auto end_optimized = std::chrono::high_resolution_clock::now();
+      const int singular_columns = screen ? column_screen.singular_count() : 0;
+      if (singular_columns > 0) {
+        std::cerr << "Warning: " << singular_columns << " columns are singular; their solutions are NaN" << std::endl;
+      }
       auto duration_optimized = std::chrono::duration_cast<std::chrono::microseconds>(end_optimized - start_optimized);
       double time_per_iter_optimized = double(duration_optimized.count()) / (1000000.0 * reps);
       
       std::cerr << "Optimized Time per iteration: " << std::fixed << std::setprecision(4) 
                 << time_per_iter_optimized << " seconds" << std::endl;
       
+      // Each iteration streams 7 ni x Nr arrays: the reset of y_optimized
+      // reads y and writes y_optimized, the sweeps read a, b, c, y_optimized
+      // and write y_optimized.  Compressed coefficients drop a and c.
+      const double bytes_per_iter =
+          (compressed ? 5.0 : 7.0) * double(n) * Nr * (fp32_storage ? sizeof(float) : sizeof(double));
+      std::cerr << "Optimized sweep bandwidth: " << std::fixed << std::setprecision(2)
+                << bytes_per_iter / time_per_iter_optimized * 1e-9 << " GB/s (alloc "
+                << hugepage::mode_name(alloc_mode) << ", " << coefficients << " coefficients, " << precision << ")"
+                << std::endl;
+      
       if (impl == "both") {
         // Calculate speedup
         auto start_naive = std::chrono::high_resolution_clock::now();
@@ -262,9 +672,57 @@ int main(int argc, char* argv[]) {
       }
     }
     
+    // Benchmark the optimized solver per storage layout
+    if (impl == "layouts") {
+      const double t_left = benchmark_layout<LeftStorage>(n, Nr, reps, tuner, a, b, c, y, y_optimized);
+      const double t_right = benchmark_layout<RightStorage>(n, Nr, reps, tuner, a, b, c, y, y_optimized);
+      const double t_tiled = benchmark_layout<TiledStorage>(n, Nr, reps, tuner, a, b, c, y, y_optimized);
+      const double t_packed = benchmark_layout<PackedStorage>(n, Nr, reps, tuner, a, b, c, y, y_optimized);
+      const char* best = LeftStorage::name;
+      double best_time = t_left;
+      if (t_right < best_time) { best = RightStorage::name; best_time = t_right; }
+      if (t_tiled < best_time) { best = TiledStorage::name; best_time = t_tiled; }
+      if (t_packed < best_time) { best = PackedStorage::name; best_time = t_packed; }
+      for (auto [name, t] : {std::pair<const char*, double>{LeftStorage::name, t_left},
+                             {RightStorage::name, t_right}, {TiledStorage::name, t_tiled},
+                             {PackedStorage::name, t_packed}}) {
+        std::cerr << "Layout " << name << " Time per iteration: " << std::fixed << std::setprecision(4) << t
+                  << " seconds" << std::endl;
+      }
+      std::cerr << "Best layout for " << ExecSpace::name() << " at n=" << n << ": " << best << std::endl;
+    }
+    
+    if (fp32_storage && (impl == "optimized" || impl == "both")) {
+      auto y_opt = y_optimized;
+      parallel_for_solver_columns("widen_from_fp32", ExecSpace(), n, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+        for (int k = 0; k < Nr; k++) y_opt(i,k) = double(y_opt32(i,k));
+      });
+      fence();
+    }
+    
+    // Compressed coefficients with --check: verify the level-only form against a full View
+    if (check) {
+      const double diff = check_level_coefficient(solver_exec, n, Nr, thomas_launch);
+      std::cerr << "Level coefficient check: max |level - full| = " << std::scientific << std::setprecision(3)
+                << diff << std::defaultfloat << std::endl;
+      if (diff != 0.0) {
+        std::cerr << "Error: level-only coefficients disagree with the full coefficient View" << std::endl;
+        status = 1;
+      }
+    }
+    
+    // Integrate the vertical diffusion; the final tracer field is the output
+    if (impl == "diffusion") {
+      const int nsteps = steps > 0 ? steps : reps;
+      const double time_per_step = run_vertical_diffusion(solver_exec, n, Nr, nsteps, coefficients == "fused",
+                                                           bathymetry == "variable", thomas_launch, y_optimized);
+      std::cerr << "Diffusion Time per step: " << std::fixed << std::setprecision(4) << time_per_step
+                << " seconds (" << nsteps << " steps)" << std::endl;
+    }
+    
     // Write output to CSV format (use appropriate result based on implementation)
     View<double**, Layout, MemSpace> result_view;
-    if (impl == "optimized") {
+    if (impl == "optimized" || impl == "layouts" || impl == "diffusion") {
       result_view = y_optimized;
     } else {
       result_view = y_naive;
@@ -282,5 +740,5 @@ int main(int argc, char* argv[]) {
   }
   finalize();
   
-  return 0;
+  return status;
 }
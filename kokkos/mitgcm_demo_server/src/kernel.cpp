@@ -0,0 +1,322 @@
+#include <Kokkos_Core.hpp>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "numa_topology.hpp"
+#include "solver_context.hpp"
+
+using namespace Kokkos;
+
+// Long-running mitgcm solver server.  Kokkos is initialized once, and one
+// ThomasSolverContext keeps the thread pool, launch parameters and workspace
+// warm, so each request pays only for its solves instead of a process start,
+// runtime initialization and first touch.
+//
+// Requests are single lines, read from stdin or from clients of a Unix socket
+// (--socket <path>), e.g.
+//   printf 'solve 1024 10 checksum\n' | socat - UNIX-CONNECT:/tmp/thomas.sock
+//
+//   solve <n> <reps> [csv|checksum|none]   benchmark problem of the mitgcm
+//                                          drivers; csv rows match their output
+//   stats                                  requests and solves served so far
+//   quit                                   end this session
+//   shutdown                               stop the server
+//
+// Every request is answered with its payload (if any) followed by one status
+// line, "ok ..." or "error <message>".
+
+constexpr int Nr = 50;  // vertical levels (typical MITgcm)
+
+// Benchmark problem of the mitgcm drivers, kept on the device and rebuilt only
+// when a request asks for a different size
+struct Problem {
+  int n = -1;
+  View<double**, Layout, MemSpace> a, b, c, y0, y;
+
+  // The old problem is released first; if an allocation throws, the problem
+  // is left empty and rebuilt by the next request.
+  void ensure(const ExecSpace& exec, int new_n) {
+    if (new_n == n) return;
+    *this = Problem{};
+    auto alloc = [&](const char* label) {
+      return View<double**, Layout, MemSpace>(view_alloc(WithoutInitializing, label), new_n, Nr);
+    };
+    a = alloc("a");
+    b = alloc("b");
+    c = alloc("c");
+    y0 = alloc("y0");
+    y = alloc("y");
+    n = new_n;
+    constexpr double pi = 3.141592653589793;
+    auto a_ = a, b_ = b, c_ = c, y0_ = y0, y_ = y;
+    const int n_ = n;
+    // First touch with the solver's column partitioning (see thomas_solver.hpp)
+    parallel_for_solver_columns("init_matrices", exec, n, tuning::LaunchParams{}, KOKKOS_LAMBDA(int i) {
+      for (int k = 0; k < Nr; k++) {
+        a_(i,k) = (k > 0) ? -0.5 : 0.0;
+        b_(i,k) = 2.0 + 0.1 * std::sin(pi * double(i+1)/double(n_));
+        c_(i,k) = (k < Nr-1) ? -0.5 : 0.0;
+        y0_(i,k) = std::sin(pi * double(i+1)/double(n_)) * std::cos(pi * double(k+1)/double(Nr));
+        y_(i,k) = 0.0;
+      }
+    });
+  }
+};
+
+struct ServerState {
+  explicit ServerState(ThomasSolverContext& c) : ctx(c) {}
+
+  ThomasSolverContext& ctx;
+  Problem problem;
+  long requests = 0;
+  bool shutdown = false;
+};
+
+// Handles one request line; returns false when the session should end.
+bool handle_request(const std::string& line, ServerState& state, std::ostream& out) {
+  std::istringstream in(line);
+  std::string cmd;
+  if (!(in >> cmd)) return true;  // blank line
+  state.requests++;
+
+  if (cmd == "quit") {
+    out << "ok bye" << std::endl;
+    return false;
+  }
+  if (cmd == "shutdown") {
+    state.shutdown = true;
+    out << "ok shutting down" << std::endl;
+    return false;
+  }
+  if (cmd == "stats") {
+    out << "ok requests=" << state.requests << " solves=" << state.ctx.solves()
+        << " problem_n=" << state.problem.n << std::endl;
+    return true;
+  }
+  if (cmd != "solve") {
+    out << "error unknown request '" << cmd << "'" << std::endl;
+    return true;
+  }
+
+  int n = 0, reps = 0;
+  std::string output = "none";
+  if (!(in >> n >> reps) || n < 1 || reps < 1) {
+    out << "error usage: solve <n> <reps> [csv|checksum|none]" << std::endl;
+    return true;
+  }
+  in >> output;
+  if (output != "csv" && output != "checksum" && output != "none") {
+    out << "error unknown output '" << output << "'" << std::endl;
+    return true;
+  }
+
+  const ExecSpace& exec = state.ctx.exec();
+  Problem& p = state.problem;
+  p.ensure(exec, n);
+  auto a_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(p.a);
+  auto b_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(p.b);
+  auto c_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(p.c);
+  exec.fence("problem_setup");
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int rep = 0; rep < reps; rep++) {
+    deep_copy(exec, p.y, p.y0);
+    state.ctx.solve(n, Nr, a_const, b_const, c_const, p.y);
+  }
+  exec.fence("solve_request");
+  auto end = std::chrono::high_resolution_clock::now();
+  double time_per_iter = std::chrono::duration<double>(end - start).count() / reps;
+
+  if (output != "none") {
+    auto h_y = create_mirror_view_and_copy(HostSpace{}, p.y);
+    if (output == "csv") {
+      for (int i = 0; i < n; i++) {
+        for (int k = 0; k < Nr; k++) {
+          out << std::fixed << std::setprecision(10) << h_y(i,k);
+          if (k < Nr-1) out << ",";
+        }
+        out << "\n";
+      }
+    } else {
+      double sum = 0.0;
+      for (int i = 0; i < n; i++) {
+        for (int k = 0; k < Nr; k++) sum += h_y(i,k);
+      }
+      out << "checksum " << std::scientific << std::setprecision(16) << sum << std::defaultfloat << "\n";
+    }
+  }
+  out << "ok n=" << n << " reps=" << reps << " time_per_iteration=" << std::scientific << std::setprecision(6)
+      << time_per_iter << std::defaultfloat << std::endl;
+  return true;
+}
+
+// Minimal std::streambuf over a connected socket so sessions on stdin/stdout
+// and on Unix sockets share handle_request.
+class FdStreamBuf : public std::streambuf {
+ public:
+  explicit FdStreamBuf(int fd) : m_fd(fd) {
+    setg(m_in, m_in, m_in);
+    setp(m_out, m_out + sizeof(m_out));
+  }
+  ~FdStreamBuf() override { flush_out(); }
+
+ protected:
+  int_type underflow() override {
+    ssize_t got = ::read(m_fd, m_in, sizeof(m_in));
+    if (got <= 0) return traits_type::eof();
+    setg(m_in, m_in, m_in + got);
+    return traits_type::to_int_type(*gptr());
+  }
+  int_type overflow(int_type ch) override {
+    if (flush_out() < 0) return traits_type::eof();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+  int sync() override { return flush_out(); }
+
+ private:
+  int flush_out() {
+    for (char* p = pbase(); p < pptr();) {
+      ssize_t written = ::write(m_fd, p, pptr() - p);
+      if (written <= 0) return -1;
+      p += written;
+    }
+    setp(m_out, m_out + sizeof(m_out));
+    return 0;
+  }
+
+  int m_fd;
+  char m_in[4096];
+  char m_out[65536];
+};
+
+void serve_session(std::istream& in, std::ostream& out, ServerState& state) {
+  std::string line;
+  while (std::getline(in, line)) {
+    // A failed request (e.g. std::bad_alloc for an n the device cannot hold)
+    // is answered with an error; the server keeps running
+    try {
+      if (!handle_request(line, state, out)) break;
+    } catch (const std::exception& e) {
+      out << "error request failed: " << e.what() << std::endl;
+    }
+  }
+  out.flush();
+}
+
+int serve_socket(const std::string& path, ServerState& state) {
+  int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (listen_fd < 0 || path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "Error: cannot create socket " << path << std::endl;
+    return 1;
+  }
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  ::unlink(path.c_str());
+  if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listen_fd, 8) != 0) {
+    std::cerr << "Error: cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+    ::close(listen_fd);
+    return 1;
+  }
+  std::cerr << "Listening on " << path << std::endl;
+
+  // One client at a time; requests from a client are answered in order
+  while (!state.shutdown) {
+    int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      std::cerr << "Error: accept failed: " << std::strerror(errno) << std::endl;
+      break;
+    }
+    {
+      FdStreamBuf buf(fd);
+      std::istream in(&buf);
+      std::ostream out(&buf);
+      serve_session(in, out, state);
+    }
+    ::close(fd);
+  }
+  ::close(listen_fd);
+  ::unlink(path.c_str());
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  std::string socket_path;
+  int warmup_n = 1024;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--socket" && i + 1 < argc) {
+      socket_path = argv[++i];
+    } else if (arg == "--warmup-n" && i + 1 < argc) {
+      warmup_n = std::atoi(argv[++i]);
+    } else if (arg == "--help") {
+      std::cerr << "Usage: " << argv[0] << " [--socket <path>] [--warmup-n <n>]" << std::endl;
+      std::cerr << "  options: --tune  --tuning-cache <path>" << std::endl;
+      std::cerr << "  requests: solve <n> <reps> [csv|checksum|none] | stats | quit | shutdown" << std::endl;
+      return 0;
+    }
+  }
+
+  // A client that disconnects mid-reply must not kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  initialize(argc, argv);
+  int status = 0;
+  {
+    ThomasSolverContext ctx;
+    numa::report_topology(std::cerr);
+
+    // Launch parameters: searched with --tune, otherwise loaded from the cache,
+    // then kept for the lifetime of the server
+    if (warmup_n > 0) ctx.warm_up(warmup_n, Nr);
+    tuning::LaunchTuner tuner = tuning::LaunchTuner::from_args(argc, argv);
+    if (warmup_n > 0) {
+      Problem probe;
+      probe.ensure(ctx.exec(), warmup_n);
+      auto a_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(probe.a);
+      auto b_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(probe.b);
+      auto c_const = View<const double**, Layout, MemSpace, ReadOnlyTraits>(probe.c);
+      ctx.set_launch(tuner.select("thomas_solver_optimized", long(warmup_n) * Nr, tuning::LaunchParams{},
+                                  tuning::team_candidates(ExecSpace().concurrency()),
+                                  [&](const tuning::LaunchParams& p) {
+                                    deep_copy(probe.y, probe.y0);
+                                    solve_tridiagonal_columns(ctx.exec(), warmup_n, Nr, AllColumns{}, a_const,
+                                                              b_const, c_const, probe.y, p);
+                                  }));
+    }
+    ctx.fence();
+    double startup = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cerr << "Startup (runtime, warmup, tuning): " << std::fixed << std::setprecision(4) << startup
+              << " seconds" << std::endl;
+
+    ServerState state(ctx);
+    if (socket_path.empty()) {
+      serve_session(std::cin, std::cout, state);
+    } else {
+      status = serve_socket(socket_path, state);
+    }
+    std::cerr << "Served " << state.requests << " requests, " << ctx.solves() << " solves" << std::endl;
+  }
+  finalize();
+
+  return status;
+}
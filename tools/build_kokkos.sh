@@ -9,7 +9,9 @@ esac; done
 [[ -z "$KERNEL" ]] && { echo "need --kernel"; exit 2; }
 
 mkdir -p "kokkos/$KERNEL/src" "kokkos/$KERNEL/build" && cd "kokkos/$KERNEL"
-# Minimal CMake; assumes Kokkos available via module or find_package
+# Minimal CMake for new kernels; assumes Kokkos available via module or find_package.
+# Existing CMakeLists.txt files are kept (some kernels add include dirs or extra targets).
+if [[ ! -f CMakeLists.txt ]]; then
 cat > CMakeLists.txt <<'EOF'
 cmake_minimum_required(VERSION 3.20)
 project(kokkos_port LANGUAGES CXX)
@@ -25,6 +27,7 @@ find_package(Kokkos REQUIRED)
 add_executable(kernel src/kernel.cpp)
 target_link_libraries(kernel Kokkos::kokkos)
 EOF
+fi
 
 cmake -S . -B build \
   -DKokkos_ENABLE_OPENMP=$([[ "$BACKEND" == "openmp" ]] && echo ON || echo OFF) \
@@ -1,11 +1,17 @@
 import numpy as np, argparse, sys, os
+# Default max_abs_diff tolerance per --precision of the optimized solver:
+# fp32 storage rounds every input and output to ~6e-8 relative, and fp32
+# sweeps accumulate that over the column
+TOLERANCES = {"fp64": 1e-10, "mixed": 1e-6, "fp32": 1e-5}
 p=argparse.ArgumentParser()
 p.add_argument("--fortran", required=True)
 p.add_argument("--kokkos", required=True)
-p.add_argument("--tol", type=float, default=1e-10)
+p.add_argument("--precision", choices=sorted(TOLERANCES), default="fp64")
+p.add_argument("--tol", type=float, default=None, help="overrides the --precision default")
 a=p.parse_args()
+tol = TOLERANCES[a.precision] if a.tol is None else a.tol
 f=np.loadtxt(a.fortran, delimiter=",")
 k=np.loadtxt(a.kokkos, delimiter=",")
 diff = 0.0 if (f.size==0 and k.size==0) else np.max(np.abs(f-k))
-print(f"max_abs_diff={diff}")
-sys.exit(0 if diff <= a.tol else 1)
+print(f"max_abs_diff={diff} tol={tol}")
+sys.exit(0 if diff <= tol else 1)
@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+# Sweep bandwidth of the optimized mitgcm solver for each allocation mode of
+# the solver arrays (Kokkos default, 2 MB aligned, 2 MB aligned + MADV_HUGEPAGE).
+set -euo pipefail
+REPS=10; SIZES="262144 1048576 4194304"; BIN="kokkos/mitgcm_demo_optimized.reference/build/kernel"
+while [[ $# -gt 0 ]]; do case "$1" in
+  --sizes) SIZES="$2"; shift 2;;
+  --reps) REPS="$2"; shift 2;;
+  --bin) BIN="$2"; shift 2;;
+  *) echo "unknown $1"; exit 2;;
+esac; done
+mkdir -p outputs
+LOG="outputs/mitgcm_alloc_bandwidth.csv"
+echo "n,alloc,time,bandwidth_gbs" | tee "$LOG"
+for N in $SIZES; do
+  for MODE in default aligned hugepage; do
+    ERR=$("$BIN" "$N" "$REPS" optimized --alloc "$MODE" 2>&1 >/dev/null)
+    T=$(awk '/^Optimized Time per iteration/ {print $5}' <<<"$ERR")
+    B=$(awk '/^Optimized sweep bandwidth/ {print $4}' <<<"$ERR")
+    echo "$N,$MODE,$T,$B" | tee -a "$LOG"
+  done
+done
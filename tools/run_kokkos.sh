@@ -1,16 +1,28 @@
 #!/usr/bin/env bash
 set -euo pipefail
-KERNEL=""; N=1024; REPS=2; SBATCH=0
+KERNEL=""; N=1024; REPS=2; SBATCH=0; SERVER=""
 while [[ $# -gt 0 ]]; do case "$1" in
   --kernel) KERNEL="$2"; shift 2;;
   --n) N="$2"; shift 2;;
   --reps) REPS="$2"; shift 2;;
   --sbatch) SBATCH=1; shift;;
+  --server) SERVER="$2"; shift 2;;  # Unix socket of a running mitgcm_demo_server
   *) echo "unknown $1"; exit 2;;
 esac; done
 BIN="kokkos/$KERNEL/build/kernel"
 mkdir -p outputs
-if [[ $SBATCH -eq 1 ]]; then
+if [[ -n "$SERVER" ]]; then
+  # Reuse the warm server instead of starting a process per run
+  python3 - "$SERVER" "$N" "$REPS" <<'EOF' | tee "outputs/${KERNEL:-server}_kokkos.log"
+import socket, sys
+path, n, reps = sys.argv[1:4]
+s = socket.socket(socket.AF_UNIX)
+s.connect(path)
+s.sendall(f"solve {n} {reps} csv\nquit\n".encode())
+while chunk := s.recv(65536):
+    sys.stdout.write(chunk.decode())
+EOF
+elif [[ $SBATCH -eq 1 ]]; then
   sbatch .slurm/run_kokkos.sbatch "$BIN" "$N" "$REPS"
 else
   "$BIN" "$N" "$REPS" | tee "outputs/${KERNEL}_kokkos.log"
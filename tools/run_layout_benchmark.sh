@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+# Best storage layout (left, right, tiled, packed) of the optimized mitgcm solver per
+# problem size on the backend the kernel was built for.
+set -euo pipefail
+REPS=10; SIZES="4096 65536 1048576"; BIN="kokkos/mitgcm_demo_optimized.reference/build/kernel"; TUNE=""
+while [[ $# -gt 0 ]]; do case "$1" in
+  --sizes) SIZES="$2"; shift 2;;
+  --reps) REPS="$2"; shift 2;;
+  --bin) BIN="$2"; shift 2;;
+  --tune) TUNE="--tune"; shift;;
+  *) echo "unknown $1"; exit 2;;
+esac; done
+mkdir -p outputs
+LOG="outputs/mitgcm_layouts.csv"
+echo "n,left,right,tiled,packed,best" | tee "$LOG"
+for N in $SIZES; do
+  # shellcheck disable=SC2086
+  ERR=$("$BIN" "$N" "$REPS" layouts $TUNE 2>&1 >/dev/null)
+  L=$(awk '/^Layout left Time/ {print $6}' <<<"$ERR")
+  R=$(awk '/^Layout right Time/ {print $6}' <<<"$ERR")
+  T=$(awk '/^Layout tiled Time/ {print $6}' <<<"$ERR")
+  P=$(awk '/^Layout packed Time/ {print $6}' <<<"$ERR")
+  B=$(awk '/^Best layout/ {print $NF}' <<<"$ERR")
+  echo "$N,$L,$R,$T,$P,$B" | tee -a "$LOG"
+done
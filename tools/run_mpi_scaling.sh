@@ -0,0 +1,26 @@
+#!/usr/bin/env bash
+# Strong scaling of cg_mpi: same problem size on 1, 2, 4, ... ranks.  The
+# --n/--reps interface and the communication/compute split are cg_mpi's own.
+set -euo pipefail
+N=1048576; REPS=5; MAX_RANKS=4; MPIRUN_ARGS=""
+while [[ $# -gt 0 ]]; do case "$1" in
+  --n) N="$2"; shift 2;;
+  --reps) REPS="$2"; shift 2;;
+  --max-ranks) MAX_RANKS="$2"; shift 2;;
+  --mpirun-args) MPIRUN_ARGS="$2"; shift 2;;
+  *) echo "unknown $1"; exit 2;;
+esac; done
+BIN="kokkos/cg_mpi/build/kernel"
+mkdir -p outputs
+LOG="outputs/cg_mpi_scaling.csv"
+echo "ranks,time,comm,compute" | tee "$LOG"
+NP=1
+while [[ $NP -le $MAX_RANKS ]]; do
+  # shellcheck disable=SC2086
+  ERR=$(mpirun -np "$NP" $MPIRUN_ARGS "$BIN" --n "$N" --reps "$REPS" 2>&1 >/dev/null)
+  T=$(awk '/^Time per iteration/ {print $4}' <<<"$ERR")
+  C=$(awk '/^Communication time per iteration/ {print $5}' <<<"$ERR")
+  P=$(awk '/^Compute time per iteration/ {print $5}' <<<"$ERR")
+  echo "$NP,$T,$C,$P" | tee -a "$LOG"
+  NP=$((NP * 2))
+done
@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+# Socket scaling of the optimized mitgcm solver, before and after solver-
+# partitioned first touch: one socket's worth of threads, then all sockets,
+# with --first-touch kokkos (Kokkos zero fill + MDRange init) and solver.
+# The N-socket runs are pinned to the CPUs of the first N NUMA nodes through
+# OMP_PLACES (one place per hardware thread, OMP_PROC_BIND=close); memory is
+# left unbound, since first-touch placement is what is being compared.
+# NUMA nodes are sockets only without sub-NUMA clustering: on SNC (Intel) or
+# NPS2/NPS4 (AMD) hosts each row is one node, i.e. a fraction of a socket.
+set -euo pipefail
+N=4194304; REPS=20; BIN="kokkos/mitgcm_demo_optimized.reference/build/kernel"
+while [[ $# -gt 0 ]]; do case "$1" in
+  --n) N="$2"; shift 2;;
+  --reps) REPS="$2"; shift 2;;
+  --bin) BIN="$2"; shift 2;;
+  *) echo "unknown $1"; exit 2;;
+esac; done
+NODE_DIRS=($(ls -d /sys/devices/system/node/node[0-9]* 2>/dev/null | sort -V))
+NODES=${#NODE_DIRS[@]}
+
+# OMP_PLACES with one place per CPU of the first $1 NUMA nodes
+places_for_nodes() {
+  local places="" list range cpu
+  for ((n = 0; n < $1; n++)); do
+    list=$(cat "${NODE_DIRS[$n]}/cpulist")
+    for range in ${list//,/ }; do
+      for cpu in $(seq "${range%-*}" "${range#*-}"); do places+="{$cpu},"; done
+    done
+  done
+  echo "${places%,}"
+}
+
+mkdir -p outputs
+LOG="outputs/mitgcm_numa_scaling.csv"
+echo "sockets,threads,first_touch,time" | tee "$LOG"
+if [[ $NODES -eq 0 ]]; then
+  # No sysfs topology: a single unpinned row
+  for MODE in kokkos solver; do
+    ERR=$("$BIN" "$N" "$REPS" optimized --first-touch "$MODE" 2>&1 >/dev/null)
+    T=$(awk '/^Optimized Time per iteration/ {print $5}' <<<"$ERR")
+    echo "1,$(nproc --all),$MODE,$T" | tee -a "$LOG"
+  done
+  exit 0
+fi
+SOCKETS=1
+while [[ $SOCKETS -le $NODES ]]; do
+  PLACES=$(places_for_nodes "$SOCKETS")
+  THREADS=$(tr ',' '\n' <<<"$PLACES" | wc -l)
+  for MODE in kokkos solver; do
+    ERR=$(OMP_NUM_THREADS="$THREADS" OMP_PLACES="$PLACES" OMP_PROC_BIND=close \
+          "$BIN" "$N" "$REPS" optimized --first-touch "$MODE" 2>&1 >/dev/null)
+    T=$(awk '/^Optimized Time per iteration/ {print $5}' <<<"$ERR")
+    echo "$SOCKETS,$THREADS,$MODE,$T" | tee -a "$LOG"
+  done
+  SOCKETS=$((SOCKETS + 1))
+done